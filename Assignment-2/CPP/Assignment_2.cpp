@@ -27,6 +27,10 @@
 
 #include "Assignment_2.h"
 #include "Util/Options.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <thread>
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -37,15 +41,23 @@ using namespace z3;
 /// You will need to collect each path from src node to snk node and then add the path to the `paths` set by
 /// calling the `collectAndTranslatePath` method, in which translatePath method is called.
 /// This implementation, slightly different from Assignment-1, requires ICFGNode* as the first argument.
+/// If isIncremental() holds, call pushEdge/popEdge when an edge is appended to/removed from `path`, and do not explore
+/// the successors of an edge for which pushEdge returns false. Stop exploring once isBudgetExhausted() holds.
+/// If isUnrollBounded() holds, bound back edges with enterLoopEdge/leaveLoopEdge instead of `visited`, and if
+/// isMerging() holds, stash the state at merge edges and resume from the merge point via pushMergedState.
 void SSE::reachability(const ICFGEdge* curEdge, const ICFGNode* snk) {
 	/// TODO: your code starts from here
 }
 
 /// TODO: collect each path once this method is called during reachability analysis, and
 /// Collect each program path from the entry to each assertion of the program. In this function,
-/// you will need (1) add each path into the paths set; (2) call translatePath to convert each path into Z3 expressions.
-/// Note that translatePath returns true if the path is feasible, false if the path is infeasible; (3) If a path is feasible,
-/// you will need to call assertchecking to verify the assertion (which is the last ICFGNode of this path); (4) reset z3 solver.
+/// you will need (1) add each path into the paths set via `recordPath(path)`, which only counts the path instead of
+/// keeping it when -sse-stream-paths is on; (2) call translatePath to convert each path into Z3 expressions.
+/// Note that translatePath returns true if the path is feasible, false if the path is infeasible (if isIncremental()
+/// holds, the path has already been encoded by pushEdge and translatePath must not be called again); (3) If a path is feasible,
+/// you will need to call assertchecking to verify the assertion (which is the last ICFGNode of this path); (4) reset z3 solver,
+/// except if isIncremental() holds: the solver then keeps the prefix shared with the next path, which popEdge unwinds.
+/// If isParallel() holds (-sse-threads), only call recordPath: the paths are translated and checked by worker threads.
 void SSE::collectAndTranslatePath() {
 	/// TODO: your code starts from here
 }
@@ -77,145 +89,648 @@ bool SSE::handleBranch(const IntraCFGEdge* edge) {
 	return true;
 }
 
-/// TODO: Translate AddrStmt, CopyStmt, LoadStmt, StoreStmt, GepStmt and CmpStmt
+/// TODO: Translate AddrStmt, CopyStmt, LoadStmt, StoreStmt, GepStmt and CmpStmt in their handlers below
 /// Translate AddrStmt, CopyStmt, LoadStmt, StoreStmt, GepStmt, BinaryOPStmt, CmpStmt, SelectStmt, and PhiStmt
+/// Each statement is dispatched on its kind (SVFStmt::getEdgeKind()) to the handler registered in getStmtDispatcher
+/// With -sse-threads the handlers run in several workers at once: look up SVFIR nodes with getSVFVar, not `svfir`
 bool SSE::handleNonBranch(const IntraCFGEdge* edge) {
 	const ICFGNode* dstNode = edge->getDstNode();
-	const ICFGNode* srcNode = edge->getSrcNode();
 	DBOP(if(!SVFUtil::isa<CallICFGNode>(dstNode) && !SVFUtil::isa<RetICFGNode>(dstNode)) std::cout << "\n## Analyzing "<< dstNode->toString() << "\n");
 
+	const SSEStmtDispatcher& dispatcher = getStmtDispatcher();
 	for (const SVFStmt *stmt : dstNode->getSVFStmts())
-	{
-		if (const AddrStmt *addr = SVFUtil::dyn_cast<AddrStmt>(stmt))
-		{
-			// TODO: implement AddrStmt handler here
-		}
-		else if (const CopyStmt *copy = SVFUtil::dyn_cast<CopyStmt>(stmt))
+		dispatcher.dispatch(*this, stmt, edge);
+
+	return true;
+}
+
+/// BranchStmts are handled when traversing conditional IntraCFGEdges (handleBranch), and CallPE/RetPE on
+/// call/return edges (handleCall/handleRet)
+const SSE::SSEStmtDispatcher& SSE::getStmtDispatcher() {
+	static const SSEStmtDispatcher dispatcher = []() {
+		SSEStmtDispatcher d;
+		d.set<SVFStmt::Addr, AddrStmt, &SSE::handleAddr>();
+		d.set<SVFStmt::Copy, CopyStmt, &SSE::handleCopy>();
+		d.set<SVFStmt::Load, LoadStmt, &SSE::handleLoad>();
+		d.set<SVFStmt::Store, StoreStmt, &SSE::handleStore>();
+		d.set<SVFStmt::Gep, GepStmt, &SSE::handleGep>();
+		d.set<SVFStmt::Cmp, CmpStmt, &SSE::handleCmp>();
+		d.set<SVFStmt::BinaryOp, BinaryOPStmt, &SSE::handleBinary>();
+		d.set<SVFStmt::Select, SelectStmt, &SSE::handleSelect>();
+		d.set<SVFStmt::Phi, PhiStmt, &SSE::handlePhi>();
+		for (SVFStmt::PEDGEK kind : {SVFStmt::Branch, SVFStmt::UnaryOp, SVFStmt::Call, SVFStmt::Ret,
+		                             SVFStmt::ThreadFork, SVFStmt::ThreadJoin})
+			d.ignore(kind);
+		return d;
+	}();
+	return dispatcher;
+}
+
+void SSE::handleAddr(const AddrStmt* addr, const IntraCFGEdge* edge) {
+	// TODO: implement AddrStmt handler here
+}
+
+void SSE::handleCopy(const CopyStmt* copy, const IntraCFGEdge* edge) {
+	// TODO: implement CopyStmt handler her
+}
+
+void SSE::handleLoad(const LoadStmt* load, const IntraCFGEdge* edge) {
+	// TODO: implement LoadStmt handler here
+}
+
+void SSE::handleStore(const StoreStmt* store, const IntraCFGEdge* edge) {
+	// TODO: implement StoreStmt handler here
+}
+
+void SSE::handleGep(const GepStmt* gep, const IntraCFGEdge* edge) {
+	// TODO: implement GepStmt handler here
+}
+
+/// Given a CmpStmt "r = a > b"
+/// cmp->getOpVarID(0)/cmp->getOpVarID(1) returns the first/second operand, i.e., "a" and "b"
+/// cmp->getResID() returns the result operand "r" and cmp->getPredicate() gives you the predicate ">"
+/// Find the comparison predicates in "class CmpStmt:Predicate" under SVF/svf/include/SVFIR/SVFStatements.h
+/// You are only required to handle integer predicates, including ICMP_EQ, ICMP_NE, ICMP_UGT, ICMP_UGE, ICMP_ULT, ICMP_ULE, ICMP_SGT, ICMP_SGE, ICMP_SLE, ICMP_SLT
+/// We assume integer-overflow-free in this assignment
+/// Use getNumeral(...) rather than getCtx().int_val(...) for constants so that -sse-encoding=bv32/bv64 also works
+void SSE::handleCmp(const CmpStmt* cmp, const IntraCFGEdge* edge) {
+	// TODO: implement CmpStmt handler here
+}
+
+void SSE::handleBinary(const BinaryOPStmt* binary, const IntraCFGEdge* edge) {
+	expr op0 = getZ3Expr(binary->getOpVarID(0));
+	expr op1 = getZ3Expr(binary->getOpVarID(1));
+	expr res = getZ3Expr(binary->getResID());
+	addToSolver(res == z3Mgr->getBinaryExpr(binary->getOpcode(), op0, op1));
+}
+
+void SSE::handleSelect(const SelectStmt* select, const IntraCFGEdge* edge) {
+	expr res = getZ3Expr(select->getResID());
+	expr tval = getZ3Expr(select->getTrueValue()->getId());
+	expr fval = getZ3Expr(select->getFalseValue()->getId());
+	expr cond = getZ3Expr(select->getCondition()->getId());
+	addToSolver(res == ite(cond == getNumeral(1), tval, fval));
+}
+
+void SSE::handlePhi(const PhiStmt* phi, const IntraCFGEdge* edge) {
+	const ICFGNode* srcNode = edge->getSrcNode();
+	expr res = getZ3Expr(phi->getResID());
+	bool opINodeFound = false;
+	for(u32_t i = 0; i < phi->getOpVarNum(); i++){
+		assert(srcNode && "we don't have a predecessor ICFGNode?");
+		if (srcNode->getFun()->postDominate(srcNode->getBB(),phi->getOpICFGNode(i)->getBB()))
 		{
-			// TODO: implement CopyStmt handler her
+			expr ope = getZ3Expr(phi->getOpVar(i)->getId());
+			addToSolver(res == ope);
+			opINodeFound = true;
 		}
-		else if (const LoadStmt *load = SVFUtil::dyn_cast<LoadStmt>(stmt))
-		{
-			// TODO: implement LoadStmt handler here
+	}
+	assert(opINodeFound && "predecessor ICFGNode of this PhiStmt not found?");
+}
+
+/// Record a collected path, either in the `paths` set or, in streaming mode, only as a counter plus an optional
+/// line in the spill file. The string of the path under checking is kept in `curPath` for failure reports.
+void SSE::recordPath(const std::vector<const ICFGEdge*>& path) {
+	pathNum++;
+	curPath = pathToString(path);
+	if (SSEOptions::StreamPaths()) {
+		if (pathLog.is_open())
+			pathLog << curPath << "\n";
+	}
+	else {
+		paths.insert(curPath);
+	}
+	if (isParallel()) {
+		pathQueue.push_back(path);
+		// check in batches so that the queue stays bounded on programs with many paths
+		if (pathQueue.size() >= 64 * SSEOptions::Threads())
+			checkPathsInParallel();
+	}
+}
+
+SSE::PathResult SSE::checkPath(const std::vector<const ICFGEdge*>& path) {
+	PathResult res;
+	resetSolver();
+	curPath = pathToString(path);
+	std::vector<const ICFGEdge*> edges(path);
+	res.feasible = translatePath(edges);
+	if (res.feasible) {
+		u32_t failedNum = failedPaths.size();
+		assertchecking(path.back()->getDstNode());
+		res.failed = failedPaths.size() != failedNum;
+	}
+	res.report = report.str();
+	report.str("");
+	return res;
+}
+
+/// Hand the queued paths out to the workers through a shared index and merge the results in queue order.
+/// Each worker owns its own Z3SSEMgr (and thus z3::context), as a z3::context must not be shared among threads.
+void SSE::checkPathsInParallel() {
+	if (pathQueue.empty())
+		return;
+	auto start = std::chrono::steady_clock::now();
+	u32_t threadNum = std::min<u32_t>(SSEOptions::Threads(), pathQueue.size());
+	while (workers.size() < threadNum)
+		workers.emplace_back(new SSE(svfir, icfg, true));
+	for (std::unique_ptr<SSE>& worker : workers) {
+		worker->deadline = deadline;
+		worker->assertDeadline = assertDeadline;
+	}
+
+	std::vector<PathResult> results(pathQueue.size());
+	std::vector<double> busyTimes(threadNum, 0);
+	std::atomic<u32_t> next(0);
+	std::vector<std::thread> threads;
+	for (u32_t t = 0; t < threadNum; t++) {
+		threads.emplace_back([this, t, &results, &busyTimes, &next]() {
+			auto begin = std::chrono::steady_clock::now();
+			for (u32_t i = next++; i < pathQueue.size(); i = next++)
+				results[i] = workers[t]->checkPath(pathQueue[i]);
+			busyTimes[t] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	bool failed = false;
+	for (u32_t i = 0; i < results.size(); i++) {
+		SVFUtil::outs() << results[i].report;
+		if (!results[i].feasible)
+			infeasiblePathNum++;
+		if (results[i].failed) {
+			failedPaths.push_back(pathToString(pathQueue[i]));
+			failed = true;
 		}
-		else if (const StoreStmt *store = SVFUtil::dyn_cast<StoreStmt>(stmt))
-		{
-			// TODO: implement StoreStmt handler here
+	}
+	for (std::unique_ptr<SSE>& worker : workers) {
+		assert_checked += worker->workerAssertNum;
+		queryNum += worker->queryNum;
+		solvedQueryNum += worker->solvedQueryNum;
+		timeoutQueryNum += worker->timeoutQueryNum;
+		unknownQueryNum += worker->unknownQueryNum;
+		skippedQueryNum += worker->skippedQueryNum;
+		unknownVerdictNum += worker->unknownVerdictNum;
+		slicedConstraintNum += worker->slicedConstraintNum;
+		solveTime += worker->solveTime;
+		worker->solveTime = 0;
+		worker->workerAssertNum = worker->queryNum = worker->solvedQueryNum = worker->timeoutQueryNum = 0;
+		worker->unknownQueryNum = worker->skippedQueryNum = worker->unknownVerdictNum = worker->slicedConstraintNum = 0;
+		// the failures are already merged above from the results, in queue order
+		worker->failedPaths.clear();
+	}
+	for (double busy : busyTimes)
+		checkBusyTime += busy;
+	pathQueue.clear();
+	checkTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	assert(!failed && "assertion failed on a path checked in parallel");
+	(void)failed;
+}
+
+std::string SSE::pathToString(const std::vector<const ICFGEdge*>& path) const {
+	std::stringstream rawstr;
+	rawstr << "START";
+	for (const ICFGEdge* edge : path) {
+		rawstr << "->" << edge->getDstID();
+	}
+	rawstr << "->END";
+	return rawstr.str();
+}
+
+void SSE::printStat() const {
+	SVFUtil::outs().flags(std::ios::left);
+	SVFUtil::outs() << "\n-----------SSE Statistics-----------\n";
+	SVFUtil::outs() << std::setw(25) << "Encoding" << SSEOptions::Encoding() << "\n";
+	SVFUtil::outs() << std::setw(25) << "AnalysisTime(s)" << analysisTime << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Paths" << pathNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Infeasible paths" << infeasiblePathNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Feasibility checks" << feasibilityCheckNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Pruned subtrees" << prunedSubtreeNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Assertions checked" << assert_checked << "\n";
+	if (SSEOptions::Threads() > 1) {
+		SVFUtil::outs() << std::setw(25) << "#Threads" << SSEOptions::Threads() << "\n";
+		SVFUtil::outs() << std::setw(25) << "CheckTime(s)" << checkTime << "\n";
+		SVFUtil::outs() << std::setw(25) << "CheckBusyTime(s)" << checkBusyTime << "\n";
+		SVFUtil::outs() << std::setw(25) << "Parallelism(busy/wall)" << (checkTime > 0 ? checkBusyTime / checkTime : 0) << "\n";
+		SVFUtil::outs() << std::setw(25) << "#Assertions/s" << (checkTime > 0 ? assert_checked / checkTime : 0) << "\n";
+	}
+	SVFUtil::outs() << std::setw(25) << "#Undecided assertions" << unknownVerdictNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Failed paths" << failedPaths.size() << "\n";
+	for (const std::string& p : failedPaths)
+		SVFUtil::outs() << "\t" << p << "\n";
+	SVFUtil::outs() << "-----------------------------------------\n";
+	if (isMerging()) {
+		SVFUtil::outs() << std::setw(25) << "#Merge points" << mergePointNum << "\n";
+		SVFUtil::outs() << std::setw(25) << "#Merged states" << mergedStateNum << "\n";
+	}
+	if (isUnrollBounded()) {
+		SVFUtil::outs() << std::setw(25) << "Unroll bound" << SSEOptions::Unroll() << "\n";
+		for (const auto& it : loopStats) {
+			std::stringstream loop;
+			loop << "Loop " << it.first;
+			SVFUtil::outs() << std::setw(25) << loop.str() << "entries " << it.second.entries << ", max iterations "
+			          << it.second.maxIterations << ", bound hits " << it.second.boundHits << ", merged states "
+			          << it.second.mergedStates << "\n";
 		}
-		else if (const GepStmt *gep = SVFUtil::dyn_cast<GepStmt>(stmt))
-		{
-			// TODO: implement GepStmt handler here
+		SVFUtil::outs() << "-----------------------------------------\n";
+	}
+	SVFUtil::outs() << std::setw(25) << "#Queries" << queryNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Solved" << solvedQueryNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Timed out" << timeoutQueryNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Unknown" << unknownQueryNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Skipped (budget)" << skippedQueryNum << "\n";
+	SVFUtil::outs() << std::setw(25) << "SolveTime(s)" << solveTime << "\n";
+	if (SSEOptions::QueryCache())
+		queryCache.printStat();
+	if (SSEOptions::Slice())
+		SVFUtil::outs() << std::setw(25) << "#Sliced constraints" << slicedConstraintNum << "\n";
+	SVFUtil::outs() << "-----------------------------------------\n";
+	z3Mgr->printStat();
+}
+
+/// Traverse each program path
+bool SSE::translatePath(std::vector<const ICFGEdge*>& path) {
+	for (const ICFGEdge* edge : path) {
+		if (translateEdge(edge) == false) {
+			infeasiblePathNum++;
+			return false;
 		}
-		/// Given a CmpStmt "r = a > b"
-		/// cmp->getOpVarID(0)/cmp->getOpVarID(1) returns the first/second operand, i.e., "a" and "b"
-		/// cmp->getResID() returns the result operand "r" and cmp->getPredicate() gives you the predicate ">"
-		/// Find the comparison predicates in "class CmpStmt:Predicate" under SVF/svf/include/SVFIR/SVFStatements.h
-		/// You are only required to handle integer predicates, including ICMP_EQ, ICMP_NE, ICMP_UGT, ICMP_UGE, ICMP_ULT, ICMP_ULE, ICMP_SGT, ICMP_SGE, ICMP_SLE, ICMP_SLT
-		/// We assume integer-overflow-free in this assignment
-		else if (const CmpStmt *cmp = SVFUtil::dyn_cast<CmpStmt>(stmt))
-		{
-			// TODO: implement CmpStmt handler here
+	}
+
+	return true;
+}
+
+bool SSE::translateEdge(const ICFGEdge* edge) {
+	if (const IntraCFGEdge* intraEdge = SVFUtil::dyn_cast<IntraCFGEdge>(edge)) {
+		return handleIntra(intraEdge);
+	}
+	else if (const CallCFGEdge* call = SVFUtil::dyn_cast<CallCFGEdge>(edge)) {
+		handleCall(call);
+	}
+	else if (const RetCFGEdge* ret = SVFUtil::dyn_cast<RetCFGEdge>(edge)) {
+		handleRet(ret);
+	}
+	else
+		assert(false && "what other edges we have?");
+	return true;
+}
+
+/// Open a solver scope for the edge and encode it on top of the prefix encoded so far.
+/// The calling context and the memory model are saved as they are updated outside the solver.
+/// A branch edge additionally triggers a feasibility check of the prefix according to -sse-prune.
+bool SSE::pushEdge(const ICFGEdge* edge) {
+	u32_t branchNum = scopes.empty() ? 0 : scopes.back().branchNum;
+	const IntraCFGEdge* branch = SVFUtil::dyn_cast<IntraCFGEdge>(edge);
+	if (branch && branch->getCondition() == nullptr)
+		branch = nullptr;
+	scopes.push_back(SolverScope{callingCtx, z3Mgr->getMemModel(), branch ? branchNum + 1 : branchNum});
+	getSolver().push();
+	if (translateEdge(edge) == false) {
+		prunedSubtreeNum++;
+		return false;
+	}
+	if (branch && needFeasibilityCheck(branch, branchNum + 1)) {
+		feasibilityCheckNum++;
+		// an undecided prefix is kept, as only an unsat one can be pruned soundly
+		if (checkQuery() == z3::unsat) {
+			prunedSubtreeNum++;
+			return false;
 		}
-		else if (const BinaryOPStmt *binary = SVFUtil::dyn_cast<BinaryOPStmt>(stmt))
-		{
-			expr op0 = getZ3Expr(binary->getOpVarID(0));
-			expr op1 = getZ3Expr(binary->getOpVarID(1));
-			expr res = getZ3Expr(binary->getResID());
-			switch (binary->getOpcode())
-			{
-			case BinaryOperator::Add:
-				addToSolver(res == op0 + op1);
-				break;
-			case BinaryOperator::Sub:
-				addToSolver(res == op0 - op1);
-				break;
-			case BinaryOperator::Mul:
-				addToSolver(res == op0 * op1);
-				break;
-			case BinaryOperator::SDiv:
-				addToSolver(res == op0 / op1);
-				break;
-			case BinaryOperator::SRem:
-				addToSolver(res == op0 % op1);
-				break;
-			case BinaryOperator::Xor:
-				addToSolver(res == bv2int(int2bv(32, op0) ^ int2bv(32, op1), 1));
-				break;
-			case BinaryOperator::And:
-				addToSolver(res == bv2int(int2bv(32, op0) & int2bv(32, op1), 1));
-				break;
-			case BinaryOperator::Or:
-				addToSolver(res == bv2int(int2bv(32, op0) | int2bv(32, op1), 1));
-				break;
-			case BinaryOperator::AShr:
-				addToSolver(res == bv2int(ashr(int2bv(32, op0), int2bv(32, op1)), 1));
-				break;
-			case BinaryOperator::Shl:
-				addToSolver(res == bv2int(shl(int2bv(32, op0), int2bv(32, op1)), 1));
-				break;
-			default:
-				assert(false && "implement this part");
+	}
+	return true;
+}
+
+z3::check_result SSE::checkQuery(z3::solver& solver) {
+	TimePoint now = std::chrono::steady_clock::now();
+	TimePoint end = std::min(deadline, assertDeadline);
+	if (now >= end) {
+		skippedQueryNum++;
+		unknownReason = "budget exhausted";
+		return z3::unknown;
+	}
+	// the query may not run past the end of the budgets
+	u32_t timeout = SSEOptions::QueryTimeout();
+	if (end != TimePoint::max()) {
+		u32_t remaining = std::max<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(end - now).count(), 1);
+		timeout = timeout == 0 ? remaining : std::min(timeout, remaining);
+	}
+	z3Mgr->setQueryLimits(solver, timeout, SSEOptions::QueryRLimit());
+	queryNum++;
+	TimePoint begin = std::chrono::steady_clock::now();
+	z3::check_result res = solver.check();
+	solveTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	// the limits are for this query only, e.g., the remaining budget must not bound later checks of the solver
+	z3Mgr->setQueryLimits(solver, 0, 0);
+	if (res != z3::unknown) {
+		solvedQueryNum++;
+		return res;
+	}
+	unknownReason = solver.reason_unknown();
+	if (unknownReason.find("timeout") != std::string::npos || unknownReason.find("canceled") != std::string::npos
+	    || unknownReason.find("resource") != std::string::npos)
+		timeoutQueryNum++;
+	else
+		unknownQueryNum++;
+	return res;
+}
+
+/// Unsat answers of the cache and of a slice hold for the whole query. A sat slice, however, says nothing about the
+/// constraints left out, so the whole query is checked again to confirm the counterexample
+z3::check_result SSE::checkAssertionQuery(const z3::expr& negAssert) {
+	bool useCache = SSEOptions::QueryCache();
+	z3::model model(getCtx());
+	z3::check_result res = z3::unknown;
+	if (useCache || SSEOptions::Slice()) {
+		z3::expr_vector constraints(getCtx());
+		if (!SSEQueryCache::canonicalize(getSolver().assertions(), constraints))
+			return z3::unsat;
+		z3::expr_vector query(getCtx());
+		if (SSEOptions::Slice())
+			SSEQueryCache::slice(constraints, negAssert.simplify(), query);
+		else
+			query = constraints;
+		bool sliced = query.size() < constraints.size();
+		slicedConstraintNum += constraints.size() - query.size();
+		SSEQueryCache::Key key = SSEQueryCache::getKey(query);
+
+		if (useCache)
+			res = queryCache.lookup(key, query, model);
+		if (res == z3::unknown) {
+			if (sliced) {
+				// built like the path solver, so that -sse-tactics applies to the slice as well
+				z3::solver sliceSolver = z3Mgr->mkSolver();
+				sliceSolver.add(query);
+				res = checkQuery(sliceSolver);
+				if (res == z3::sat)
+					model = sliceSolver.get_model();
 			}
-		}
-		else if (const BranchStmt *br = SVFUtil::dyn_cast<BranchStmt>(stmt))
-		{
-			DBOP(std::cout << "\t skip handled when traversal Conditional IntraCFGEdge \n");
-		}
-		else if (const SelectStmt *select = SVFUtil::dyn_cast<SelectStmt>(stmt)) {
-			expr res = getZ3Expr(select->getResID());
-			expr tval = getZ3Expr(select->getTrueValue()->getId());
-			expr fval = getZ3Expr(select->getFalseValue()->getId());
-			expr cond = getZ3Expr(select->getCondition()->getId());
-			addToSolver(res == ite(cond == getCtx().int_val(1), tval, fval));
-		}
-		else if (const PhiStmt *phi = SVFUtil::dyn_cast<PhiStmt>(stmt)) {
-			expr res = getZ3Expr(phi->getResID());
-			bool opINodeFound = false;
-			for(u32_t i = 0; i < phi->getOpVarNum(); i++){
-				assert(srcNode && "we don't have a predecessor ICFGNode?");
-				if (srcNode->getFun()->postDominate(srcNode->getBB(),phi->getOpICFGNode(i)->getBB()))
-				{
-					expr ope = getZ3Expr(phi->getOpVar(i)->getId());
-					addToSolver(res == ope);
-					opINodeFound = true;
-				}
+			else {
+				res = checkQuery();
+				if (res == z3::sat)
+					model = getSolver().get_model();
 			}
-			assert(opINodeFound && "predecessor ICFGNode of this PhiStmt not found?");
+			if (useCache && res != z3::unknown)
+				queryCache.insert(key, query, res, model);
+		}
+		if (res != z3::sat)
+			return res;
+		if (!sliced) {
+			std::stringstream ss;
+			ss << model;
+			counterexample = ss.str();
+			return res;
 		}
 	}
+	res = checkQuery();
+	if (res == z3::sat) {
+		std::stringstream ss;
+		ss << getSolver().get_model();
+		counterexample = ss.str();
+	}
+	return res;
+}
 
+bool SSE::needFeasibilityCheck(const IntraCFGEdge* edge, u32_t branchNum) const {
+	switch (pruneMode) {
+	case PruneAtBranch: return true;
+	case PruneEveryN: return branchNum % std::max(SSEOptions::PruneInterval(), 1u) == 0;
+	case PruneAtLoopExit: return isLoopExitEdge(edge);
+	default: return false;
+	}
+}
+
+bool SSE::isLoopExitEdge(const IntraCFGEdge* edge) const {
+	const ICFGNode* src = edge->getSrcNode();
+	const ICFGNode* dst = edge->getDstNode();
+	const FunObjVar* fun = src->getFun();
+	if (fun == nullptr || src->getBB() == nullptr || dst->getBB() == nullptr || !fun->hasLoopInfo(src->getBB()))
+		return false;
+	return !fun->loopContainsBB(fun->getLoopInfo(src->getBB()), dst->getBB());
+}
+
+SSE::PruneMode SSE::parsePruneMode(const std::string& mode) {
+	if (mode == "none")
+		return NoPrune;
+	else if (mode == "branch")
+		return PruneAtBranch;
+	else if (mode == "every-n")
+		return PruneEveryN;
+	else if (mode == "loop-exit")
+		return PruneAtLoopExit;
+	std::cerr << "Unknown -sse-prune mode: " << mode << "\n";
+	abort();
+}
+
+u32_t SSE::parseBVWidth(const std::string& encoding) {
+	if (encoding == "int")
+		return 0;
+	else if (encoding == "bv32")
+		return 32;
+	else if (encoding == "bv64")
+		return 64;
+	std::cerr << "Unknown -sse-encoding: " << encoding << "\n";
+	abort();
+}
+
+const ICFGNode* SSE::getLoopHeader(const ICFGEdge* edge, bool& isBackEdge) const {
+	const ICFGNode* src = edge->getSrcNode();
+	const ICFGNode* dst = edge->getDstNode();
+	if (!SVFUtil::isa<IntraCFGEdge>(edge) || src == nullptr || dst->getFun() == nullptr)
+		return nullptr;
+	if (src->getBB() == nullptr || !isLoopHeader(dst))
+		return nullptr;
+	const FunObjVar* fun = dst->getFun();
+	isBackEdge = fun->loopContainsBB(fun->getLoopInfo(dst->getBB()), src->getBB());
+	return dst;
+}
+
+bool SSE::isLoopHeader(const ICFGNode* node) const {
+	const SVFBasicBlock* bb = node->getBB();
+	return node->getFun() && bb && bb->front() == node && node->getFun()->isLoopHeader(bb);
+}
+
+/// Entering a loop starts its iteration count afresh, so that an inner loop gets k iterations per outer iteration
+bool SSE::enterLoopEdge(const ICFGEdge* edge) {
+	bool isBackEdge = false;
+	const ICFGNode* header = getLoopHeader(edge, isBackEdge);
+	if (header == nullptr) {
+		loopUndo.emplace_back(nullptr, 0);
+		return true;
+	}
+	u32_t& iterations = loopIterations[header];
+	loopUndo.emplace_back(header, iterations);
+	LoopStat& stat = loopStats[header->getId()];
+	if (!isBackEdge) {
+		stat.entries++;
+		iterations = 0;
+		return true;
+	}
+	iterations++;
+	stat.maxIterations = std::max(stat.maxIterations, iterations);
+	if (iterations > SSEOptions::Unroll()) {
+		stat.boundHits++;
+		return false;
+	}
 	return true;
 }
 
-/// Traverse each program path
-bool SSE::translatePath(std::vector<const ICFGEdge*>& path) {
-	for (const ICFGEdge* edge : path) {
-		if (const IntraCFGEdge* intraEdge = SVFUtil::dyn_cast<IntraCFGEdge>(edge)) {
-			if (handleIntra(intraEdge) == false)
-				return false;
-		}
-		else if (const CallCFGEdge* call = SVFUtil::dyn_cast<CallCFGEdge>(edge)) {
-			handleCall(call);
-		}
-		else if (const RetCFGEdge* ret = SVFUtil::dyn_cast<RetCFGEdge>(edge)) {
-			handleRet(ret);
+void SSE::leaveLoopEdge() {
+	assert(!loopUndo.empty() && "leaveLoopEdge without a matching enterLoopEdge?");
+	if (loopUndo.back().first)
+		loopIterations[loopUndo.back().first] = loopUndo.back().second;
+	loopUndo.pop_back();
+}
+
+/// Paths from a branch reach the merge point of the innermost open branch first, as a block post-dominated by the
+/// merge point of an outer branch is post-dominated by it through the inner one
+bool SSE::isMergeEdge(const ICFGEdge* edge) const {
+	if (SSEOptions::Merge() && !openMergePoints.empty() && edge->getDstNode() == openMergePoints.back().first)
+		return true;
+	bool isBackEdge = false;
+	return SSEOptions::MergeLoops() && getLoopHeader(edge, isBackEdge) && isBackEdge;
+}
+
+const ICFGNode* SSE::getMergePoint(const ICFGNode* branch) {
+	const FunObjVar* fun = branch->getFun();
+	const SVFBasicBlock* bb = branch->getBB();
+	if (!SSEOptions::Merge() || fun == nullptr || bb == nullptr || bb->back() != branch)
+		return nullptr;
+	// the post-dominator tree maps a block to the blocks it immediately post-dominates
+	if (ipdomFuns.insert(fun).second) {
+		for (const auto& it : fun->getLoopAndDomInfo()->getPostDomTreeMap()) {
+			for (const SVFBasicBlock* child : it.second)
+				ipdomOf[child] = it.first;
 		}
-		else
-			assert(false && "what other edges we have?");
+	}
+	auto it = ipdomOf.find(bb);
+	if (it == ipdomOf.end() || it->second == nullptr || it->second->getICFGNodeList().empty())
+		return nullptr;
+	return it->second->front();
+}
+
+void SSE::openMergePoint(const ICFGNode* mergePoint) {
+	openMergePoints.emplace_back(mergePoint, scopes.size());
+}
+
+void SSE::closeMergePoint() {
+	assert(!openMergePoints.empty() && "closeMergePoint without a matching openMergePoint?");
+	openMergePoints.pop_back();
+}
+
+void SSE::stashState(const ICFGNode* mergePoint) {
+	auto it = loopIterations.find(mergePoint);
+	u32_t iterations = it == loopIterations.end() ? 0 : it->second;
+	// the same choice as isMergeEdge: a branch merge point is stashed for the branch that opened it
+	StashKey key(true, iterations);
+	if (SSEOptions::Merge() && !openMergePoints.empty() && openMergePoints.back().first == mergePoint)
+		key = StashKey(false, openMergePoints.back().second);
+	mergeStash[std::make_pair(mergePoint, callingCtx)][key].push_back(
+	    StashedState{getSolver().assertions(), z3Mgr->getMemModel(), iterations});
+}
+
+/// The assertions in the solver are a prefix of those of every stashed state, as the states were stashed below the
+/// current scope (asserted, as the merge would otherwise drop constraints). Only what the states add to their
+/// longest common prefix is merged: the path condition becomes the disjunction of these suffixes and the memory
+/// model an ite over them.
+/// A branch merges the states stashed below its own scope depth. At a loop head, states that reached it after
+/// different numbers of back edges are not merged together: the states of the fewest iterations are merged, the
+/// others stay stashed for the loop head's visit at their iteration
+bool SSE::pushMergedState(const ICFGNode* mergePoint) {
+	auto it = mergeStash.find(std::make_pair(mergePoint, callingCtx));
+	if (it == mergeStash.end())
+		return false;
+	auto bucket = it->second.find(StashKey(false, scopes.size()));
+	if (bucket == it->second.end()) {
+		bucket = it->second.lower_bound(StashKey(true, 0));
+		if (bucket == it->second.end())
+			return false;
+	}
+	std::vector<StashedState> states = std::move(bucket->second);
+	it->second.erase(bucket);
+	if (it->second.empty())
+		mergeStash.erase(it);
+
+	z3::expr_vector prefix = getSolver().assertions();
+	u32_t cur = prefix.size();
+	for (const StashedState& state : states) {
+		assert(state.constraints.size() >= cur && "state stashed above the current solver scope?");
+		for (u32_t i = 0; i < cur; i++)
+			assert(state.constraints[i].id() == prefix[i].id() && "stashed state does not extend the current prefix");
+	}
+	u32_t common = states[0].constraints.size();
+	for (const StashedState& state : states) {
+		u32_t i = cur;
+		while (i < common && i < state.constraints.size()
+		        && state.constraints[i].id() == states[0].constraints[i].id())
+			i++;
+		common = i;
 	}
 
+	scopes.push_back(SolverScope{callingCtx, z3Mgr->getMemModel(), scopes.empty() ? 0 : scopes.back().branchNum});
+	getSolver().push();
+	for (u32_t i = cur; i < common; i++)
+		addToSolver(states[0].constraints[i]);
+	z3::expr pathCond = getCtx().bool_val(false);
+	z3::expr memModel = states.back().memModel;
+	for (u32_t k = states.size(); k-- > 0;) {
+		z3::expr_vector suffix(getCtx());
+		for (u32_t i = common; i < states[k].constraints.size(); i++)
+			suffix.push_back(states[k].constraints[i]);
+		z3::expr cond = z3::mk_and(suffix);
+		pathCond = cond || pathCond;
+		if (k + 1 < states.size())
+			memModel = z3::ite(cond, states[k].memModel, memModel);
+	}
+	addToSolver(pathCond);
+	z3Mgr->setMemModel(memModel);
+
+	mergedStateNum += states.size();
+	mergePointNum++;
+	if (isLoopHeader(mergePoint)) {
+		// the merged state continues at the iteration the stashed states reached
+		loopUndo.emplace_back(mergePoint, loopIterations[mergePoint]);
+		loopIterations[mergePoint] = states[0].iterations;
+		loopStats[mergePoint->getId()].mergedStates += states.size();
+	}
+	else {
+		loopUndo.emplace_back(nullptr, 0);
+	}
 	return true;
 }
 
+void SSE::popMergedState() {
+	leaveLoopEdge();
+	popEdge();
+}
+
+/// Drop the constraints of the last pushed edge and restore the state before it
+void SSE::popEdge() {
+	assert(!scopes.empty() && "popEdge without a matching pushEdge?");
+	getSolver().pop();
+	callingCtx = scopes.back().callingCtx;
+	z3Mgr->setMemModel(scopes.back().memModel);
+	scopes.pop_back();
+}
+
 /// Program entry
 void SSE::analyse() {
+	auto start = std::chrono::steady_clock::now();
+	if (SSEOptions::Budget() > 0)
+		deadline = start + std::chrono::seconds(SSEOptions::Budget());
 	for (const ICFGNode* src : identifySources()) {
 		assert(SVFUtil::isa<GlobalICFGNode>(src) && "reachability should start with GlobalICFGNode!");
 		for (const ICFGNode* sink : identifySinks()) {
 			const IntraCFGEdge startEdge(nullptr, const_cast<ICFGNode*>(src));
+			if (SSEOptions::AssertBudget() > 0)
+				assertDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(SSEOptions::AssertBudget());
 			/// start traversing from the entry to each assertion and translate each path
 			reachability(&startEdge, sink);
+			// the queued paths may start with startEdge, so check them before it goes out of scope
+			checkPathsInParallel();
 			resetSolver();
 		}
 	}
+	analysisTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (SSEOptions::PrintStat() || SSEOptions::StreamPaths())
+		printStat();
 }
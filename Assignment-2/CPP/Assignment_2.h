@@ -28,8 +28,15 @@
 #ifndef SOFTWARE_SECURITY_ANALYSIS_ASSIGNMENT_2_H
 #define SOFTWARE_SECURITY_ANALYSIS_ASSIGNMENT_2_H
 
+#include "SSEOptions.h"
+#include "SSEQueryCache.h"
+#include "StmtDispatcher.h"
 #include "SVF-LLVM/SVFIRBuilder.h"
 #include "Z3SSEMgr.h"
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
 #include <stdlib.h>
 
 namespace SVF {
@@ -39,12 +46,32 @@ namespace SVF {
 		typedef std::vector<const ICFGNode*> CallStack;
 		typedef std::pair<const ICFGEdge*, CallStack> ICFGEdgeStackPair;
 
+		/// Branch edges at which the feasibility of the path prefix is checked during traversal
+		enum PruneMode {
+			NoPrune,	/// never (only the verdict of handleBranch)
+			PruneAtBranch,	/// every branch
+			PruneEveryN,	/// every N-th branch of a path
+			PruneAtLoopExit	/// branches leaving a loop
+		};
+
+		typedef std::chrono::steady_clock::time_point TimePoint;
+
+		/// Outcome of checking an assertion on a path
+		enum Verdict {
+			Verified,	/// the negated assertion is unsat
+			Falsified,	/// a counterexample is found
+			Unknown	/// the solver gave up, e.g., on -sse-timeout/-sse-rlimit or an exhausted budget
+		};
+
+		/// Result of checking one path by a worker (-sse-threads)
+		struct PathResult {
+			bool feasible = false;
+			bool failed = false;
+			std::string report;	/// output of assertchecking, printed when results are merged
+		};
+
 		/// Constructor
-		SSE(SVFIR* s, ICFG* i)
-		: svfir(s)
-		, icfg(i) {
-			z3Mgr = new Z3SSEMgr(s);
-		}
+		SSE(SVFIR* s, ICFG* i) : SSE(s, i, false) {}
 		/// Destructor
 		virtual ~SSE() {
 			delete z3Mgr;
@@ -72,10 +99,13 @@ namespace SVF {
 			        && (fun->getName() == "assert" || fun->getName() == "svf_assert" || fun->getName() == "sink"));
 		}
 
-		/// reset z3 solver
+		/// reset z3 solver. In incremental mode the solver holds the scopes of the path prefix that popEdge restores,
+		/// so it may only be reset once the traversal has popped them all
 		virtual void resetSolver() {
+			assert(scopes.empty() && "resetSolver while pushEdge scopes are open? (skip it if isIncremental())");
 			getSolver().reset();
 			callingCtx.clear();
+			scopes.clear();
 		}
 
 		/// TODO: Implementing the collection the ICFG paths
@@ -104,40 +134,211 @@ namespace SVF {
 		bool handleNonBranch(const IntraCFGEdge* edge);
 		bool handleBranch(const IntraCFGEdge* edge);
 
+		/// Translate each kind of SVFStmt on the edge being handled, dispatched by handleNonBranch
+		///@{
+		void handleAddr(const AddrStmt* addr, const IntraCFGEdge* edge);
+		void handleCopy(const CopyStmt* copy, const IntraCFGEdge* edge);
+		void handleLoad(const LoadStmt* load, const IntraCFGEdge* edge);
+		void handleStore(const StoreStmt* store, const IntraCFGEdge* edge);
+		void handleGep(const GepStmt* gep, const IntraCFGEdge* edge);
+		void handleCmp(const CmpStmt* cmp, const IntraCFGEdge* edge);
+		void handleBinary(const BinaryOPStmt* binary, const IntraCFGEdge* edge);
+		void handleSelect(const SelectStmt* select, const IntraCFGEdge* edge);
+		void handlePhi(const PhiStmt* phi, const IntraCFGEdge* edge);
+		///@}
+
+		/// The handlers above indexed by statement kind
+		typedef StmtDispatcher<SSE, void, const IntraCFGEdge*> SSEStmtDispatcher;
+		static const SSEStmtDispatcher& getStmtDispatcher();
+
 		/// Encode the path into Z3 constraints and return true if the path is feasible, false otherwise.
 		bool translatePath(std::vector<const ICFGEdge*>& path);
 
-		/// Return true if svf_assert check is successful
+		/// Encode a single edge into Z3 constraints and return false if it makes the path infeasible
+		bool translateEdge(const ICFGEdge* edge);
+
+		/// Incremental solving (-sse-incremental or -sse-prune): the traversal calls pushEdge when it appends an edge
+		/// to `path` and popEdge when it removes it, so that sibling paths share the solver scopes of their common
+		/// prefix instead of re-translating it. pushEdge returns false once the prefix is infeasible and the subtree
+		/// below the edge can be skipped (popEdge still needs to be called).
+		///@{
+		inline bool isIncremental() const {
+			return SSEOptions::Incremental() || pruneMode != NoPrune || isMerging();
+		}
+		bool pushEdge(const ICFGEdge* edge);
+		void popEdge();
+		///@}
+
+		/// Loop-bounded unrolling (-sse-unroll=k): a path may take the back edge of a loop at most k times per entry
+		/// to the loop. The traversal calls enterLoopEdge before taking an edge and does not explore it if false is
+		/// returned; either way leaveLoopEdge is called when backtracking over the edge. Back edges are then bounded
+		/// by enterLoopEdge instead of `visited`
+		///@{
+		inline bool isUnrollBounded() const {
+			return SSEOptions::Unroll() > 0;
+		}
+		bool enterLoopEdge(const ICFGEdge* edge);
+		void leaveLoopEdge();
+		///@}
+
+		/// Return the loop header if the edge enters a loop or is a back edge of it (isBackEdge), nullptr otherwise
+		const ICFGNode* getLoopHeader(const ICFGEdge* edge, bool& isBackEdge) const;
+
+		/// Return true if the node is the first node of a loop header block
+		bool isLoopHeader(const ICFGNode* node) const;
+
+		/// State merging (-sse-merge, -sse-merge-loops, implies incremental solving). After pushEdge of an edge for
+		/// which isMergeEdge holds, the traversal calls stashState(dst) and does not go further. Once the node owning
+		/// the merge point has explored all its successors (for a loop head: the visit of the head that the back edges
+		/// return to), pushMergedState(mergePoint) encodes the disjunction of the stashed states; if it returns true
+		/// the traversal continues from the merge point's successors and then calls popMergedState.
+		/// With -sse-merge, a branch node owns the merge point returned by getMergePoint: the traversal calls
+		/// openMergePoint before exploring the branch's successors and closeMergePoint before pushMergedState, so that
+		/// every branch of an acyclic region is explored and checked once instead of once per path
+		///@{
+		inline bool isMerging() const {
+			return SSEOptions::Merge() || SSEOptions::MergeLoops();
+		}
+		const ICFGNode* getMergePoint(const ICFGNode* branch);
+		void openMergePoint(const ICFGNode* mergePoint);
+		void closeMergePoint();
+		bool isMergeEdge(const ICFGEdge* edge) const;
+		void stashState(const ICFGNode* mergePoint);
+		bool pushMergedState(const ICFGNode* mergePoint);
+		void popMergedState();
+		///@}
+
+		/// Check the constraints in the solver within -sse-timeout/-sse-rlimit and the remaining budgets, and count
+		/// the query as solved, timed out or unknown. Returns z3::unknown without calling Z3 once a budget is exhausted
+		z3::check_result checkQuery(z3::solver& solver);
+		inline z3::check_result checkQuery() {
+			return checkQuery(getSolver());
+		}
+
+		/// Check the path constraints plus the negated assertion in the solver, through the query cache
+		/// (-sse-query-cache) and on the constraints relevant to the assertion only (-sse-slice).
+		/// A counterexample found is kept in `counterexample`
+		z3::check_result checkAssertionQuery(const z3::expr& negAssert);
+
+		/// Return true once the -sse-budget of the analysis or the -sse-assert-budget of the current assertion is
+		/// used up. The traversal should then stop exploring further paths
+		inline bool isBudgetExhausted() const {
+			return std::chrono::steady_clock::now() >= std::min(deadline, assertDeadline);
+		}
+
+		/// Return true if the feasibility of the prefix needs to be checked after the branch edge is encoded
+		bool needFeasibilityCheck(const IntraCFGEdge* edge, u32_t branchNum) const;
+
+		/// Return true if the branch edge leaves a loop
+		bool isLoopExitEdge(const IntraCFGEdge* edge) const;
+
+		/// Return true if svf_assert check is successful or undecided (see checkAssertion)
 		bool assertchecking(const ICFGNode* inode) {
-			assert_checked++;
+			return checkAssertion(inode) != Falsified;
+		}
+
+		/// Check the assertion at the end of the current path and report the verdict
+		Verdict checkAssertion(const ICFGNode* inode) {
+			if (isWorker)
+				workerAssertNum++;
+			else
+				assert_checked++;
 			const CallICFGNode* callnode = SVFUtil::cast<CallICFGNode>(inode);
 			assert(callnode && isAssertFun(callnode->getCalledFunction())
 			       && "last node is not an assert call?");
 			DBOP(std::cout << "\n## Analyzing " << callnode->toString() << "\n");
 			z3::expr arg0 = getZ3Expr(callnode->getActualParms().at(0)->getId());
-			addToSolver(arg0 == getCtx().int_val(0));
-			if (getSolver().check() != z3::unsat) {
+			// scope the negated assertion so that the path constraints can be reused in incremental mode
+			getSolver().push();
+			z3::expr negAssert = arg0 == getNumeral(0);
+			addToSolver(negAssert);
+			z3::check_result res = checkAssertionQuery(negAssert);
+			if (res == z3::unknown) {
+				std::stringstream ss;
+				ss << "The assertion is undecided (" << unknownReason << ")!! (" << inode->toString() << ")" << "\n";
+				reportStream() << ss.str() << std::endl;
+				unknownVerdictNum++;
+				getSolver().pop();
+				return Unknown;
+			}
+			else if (res == z3::sat) {
 				DBOP(printExprValues());
 				std::stringstream ss;
 				ss << "The assertion is unsatisfiable!! ("<< inode->toString() << ")" << "\n";
-				ss << "Counterexample: " << getSolver().get_model() << "\n";
-				SVFUtil::outs() << ss.str() << std::endl;
-				assert(false);
-				return false;
+				ss << "Counterexample: " << counterexample << "\n";
+				reportStream() << ss.str() << std::endl;
+				failedPaths.push_back(curPath);
+				getSolver().pop();
+				// a worker leaves the failure to the merge in checkPathsInParallel
+				assert(isWorker);
+				return Falsified;
 			}
 			else {
 				DBOP(printExprValues());
 				std::stringstream ss;
 				ss << "The assertion is successfully verified!! ("<< inode->toString() << ")" << "\n";
-				SVFUtil::outs() << ss.str() << std::endl;
-				return true;
+				reportStream() << ss.str() << std::endl;
+				getSolver().pop();
+				return Verified;
 			}
 		}
 
-		std::set<std::string> getPaths() {
+		/// Record a collected path. Paths are kept in `paths` by default; in streaming mode (-sse-stream-paths)
+		/// a path is only counted and appended to the -sse-path-log file, so that memory stays bounded
+		void recordPath(const std::vector<const ICFGEdge*>& path);
+
+		/// Return the string form of a path, e.g., "START->1->2->4->5->END"
+		std::string pathToString(const std::vector<const ICFGEdge*>& path) const;
+
+		const std::set<std::string>& getPaths() const {
 			return paths;
 		}
 
+		/// Return the number of collected paths, which are not kept in `paths` with -sse-stream-paths
+		inline u32_t getPathNum() const {
+			return pathNum;
+		}
+
+		/// Return true if the traversal has undone all it did: the edges, solver scopes and loop iterations it pushed,
+		/// the merge points it opened and the states it stashed
+		inline bool isTraversalBalanced() const {
+			return path.empty() && scopes.empty() && loopUndo.empty() && openMergePoints.empty() && mergeStash.empty();
+		}
+
+		/// Return the paths whose assertion check failed
+		const std::vector<std::string>& getFailedPaths() const {
+			return failedPaths;
+		}
+
+		/// Return the number of assertion checks left undecided
+		inline u32_t getUnknownVerdictNum() const {
+			return unknownVerdictNum;
+		}
+
+		/// Parallel path checking (-sse-threads=N, N > 1): recordPath queues the path instead of the traversal
+		/// translating it, and the queued paths are checked by N worker SSEs, each owning its own Z3 context.
+		/// Results are merged in the order the paths were collected, so the output does not depend on scheduling.
+		/// The workers run the handlers concurrently on the shared SVFIR, so the handlers look up SVFIR nodes with
+		/// getSVFVar and create field objects with Z3SSEMgr (getGepObjAddress), which take the SVFIR lock, rather
+		/// than through `svfir`.
+		///@{
+		inline bool isParallel() const {
+			return !isWorker && SSEOptions::Threads() > 1;
+		}
+		void checkPathsInParallel();
+		///@}
+
+		/// Translate a whole path on a fresh solver and check its assertion (the last node of the path)
+		PathResult checkPath(const std::vector<const ICFGEdge*>& path);
+
+		/// Print the numbers of paths and assertions
+		void printStat() const;
+
+		static PruneMode parsePruneMode(const std::string& mode);
+
+		/// Return the bit width of an -sse-encoding (0 for int)
+		static u32_t parseBVWidth(const std::string& encoding);
+
 		void pushCallingCtx(const ICFGNode* c) {
 			callingCtx.push_back(c);
 		}
@@ -157,7 +358,7 @@ namespace SVF {
 		/// Add expr to Z3 solver
 		void addToSolver(z3::expr e) {
 			DBOP(std::cout << "==> " << e.simplify() << "\n");
-			getSolver().add(e);
+			z3Mgr->addToSolver(e);
 		}
 
 		/// Return Z3 expression based on ValVar ID
@@ -165,6 +366,16 @@ namespace SVF {
 			return z3Mgr->getZ3Expr(idx, callingCtx);
 		}
 
+		/// Return a numeral of the value sort (Int or bit-vector)
+		inline z3::expr getNumeral(int64_t val) const {
+			return z3Mgr->getNumeral(val);
+		}
+
+		/// Return the SVFVar of an ID, safe to call from the handlers run by parallel workers
+		inline const SVFVar* getSVFVar(NodeID id) const {
+			return z3Mgr->getSVFVar(id);
+		}
+
 		/// Return Z3 expression based on ObjVar ID
 		inline z3::expr getMemObjAddress(NodeID idx) const {
 			return z3Mgr->getMemObjAddress(idx);
@@ -183,9 +394,112 @@ namespace SVF {
 		static u32_t assert_num;
 
 	 private:
+		/// Workers are created with isWorker set: they only check the paths handed over by checkPathsInParallel
+		SSE(SVFIR* s, ICFG* i, bool worker)
+		: svfir(s)
+		, icfg(i)
+		, isWorker(worker)
+		, queryCache(SSEOptions::QueryCacheSize()) {
+			z3Mgr = new Z3SSEMgr(s, parseBVWidth(SSEOptions::Encoding()));
+			z3Mgr->setTactics(SSEOptions::Tactics());
+			pruneMode = parsePruneMode(SSEOptions::PruneMode());
+			if (SSEOptions::MergeLoops() && SSEOptions::Unroll() == 0) {
+				std::cerr << "-sse-merge-loops requires -sse-unroll\n";
+				abort();
+			}
+			// a merged state covers several paths, which a worker cannot replay from the recorded edges
+			if (isMerging() && SSEOptions::Threads() > 1) {
+				std::cerr << "state merging cannot be combined with -sse-threads\n";
+				abort();
+			}
+			if (!isWorker && SSEOptions::StreamPaths() && !SSEOptions::PathLog().empty())
+				pathLog.open(SSEOptions::PathLog(), std::ios::out | std::ios::app);
+		}
+
+		/// Assertion reports go to SVFUtil::outs(), or to `report` in a worker
+		inline std::ostream& reportStream() {
+			return isWorker ? report : SVFUtil::outs();
+		}
+
 		Z3SSEMgr* z3Mgr;
 		ICFG* icfg;
 		std::set<std::string> paths;
+		std::vector<std::string> failedPaths;	/// paths on which an assertion fails
+		std::string curPath;	/// the path currently being checked
+		std::ofstream pathLog;	/// spill file of collected paths in streaming mode
+		double analysisTime = 0;	/// seconds spent in analyse
+		u32_t pathNum = 0;		/// number of collected paths
+		u32_t infeasiblePathNum = 0;	/// number of paths found infeasible by translatePath
+		u32_t prunedSubtreeNum = 0;	/// number of infeasible prefixes whose subtrees are pruned in incremental mode
+		u32_t feasibilityCheckNum = 0;	/// number of solver calls for checking prefixes during traversal
+		PruneMode pruneMode;
+
+		bool isWorker;
+		std::stringstream report;	/// assertion reports of the path under checking (workers only)
+		u32_t workerAssertNum = 0;	/// assertions checked by this worker, added to assert_checked when merging
+		std::vector<std::unique_ptr<SSE>> workers;
+		std::vector<std::vector<const ICFGEdge*>> pathQueue;	/// collected paths not checked yet (-sse-threads)
+		double checkTime = 0;	/// wall-clock seconds spent in checkPathsInParallel
+		double checkBusyTime = 0;	/// seconds the workers spent on checking paths, summed over the workers
+
+		/// Loop unrolling and merging statistics, per loop header
+		struct LoopStat {
+			u32_t entries = 0;
+			u32_t maxIterations = 0;	/// most back edges taken by a path per entry
+			u32_t boundHits = 0;	/// back edges not taken because of -sse-unroll
+			u32_t mergedStates = 0;	/// states merged at the loop head
+		};
+		std::map<NodeID, LoopStat> loopStats;
+		Map<const ICFGNode*, u32_t> loopIterations;	/// back edges taken since the loop was entered on the current path
+		std::vector<std::pair<const ICFGNode*, u32_t>> loopUndo;	/// what leaveLoopEdge restores
+
+		/// A state waiting at a merge point: the solver assertions, the memory model and the back edges taken in the
+		/// merge point's loop (if it is a loop head) when the state reached it
+		struct StashedState {
+			z3::expr_vector constraints;
+			z3::expr memModel;
+			u32_t iterations;
+		};
+		/// Which states of a merge point are merged together: (false, d) for the states of the branch opened at scope
+		/// depth d, (true, n) for the states of a loop head after n back edges
+		typedef std::pair<bool, u32_t> StashKey;
+		/// Stashed states by merge point and calling context, then by StashKey, so that nested branches sharing a
+		/// merge point and states of different loop iterations are merged apart
+		Map<std::pair<const ICFGNode*, CallStack>, std::map<StashKey, std::vector<StashedState>>> mergeStash;
+		u32_t mergedStateNum = 0;
+		u32_t mergePointNum = 0;	/// merge points at which states have been merged
+
+		/// Merge points of the branches being explored on the current path (-sse-merge) and the scope depth at which
+		/// they were opened, innermost last
+		std::vector<std::pair<const ICFGNode*, u32_t>> openMergePoints;
+		/// Immediate post-dominator of each block, filled per function from its post-dominator tree
+		Map<const SVFBasicBlock*, const SVFBasicBlock*> ipdomOf;
+		Set<const FunObjVar*> ipdomFuns;
+
+		/// Solver queries and budgets (-sse-timeout, -sse-rlimit, -sse-budget, -sse-assert-budget)
+		///@{
+		TimePoint deadline = TimePoint::max();	/// end of the budget of the whole analysis
+		TimePoint assertDeadline = TimePoint::max();	/// end of the budget of the assertion being analysed
+		std::string unknownReason;	/// why the last query returned unknown
+		std::string counterexample;	/// model of the last sat assertion query
+		SSEQueryCache queryCache;
+		u32_t slicedConstraintNum = 0;	/// constraints dropped by -sse-slice
+		u32_t queryNum = 0;
+		u32_t solvedQueryNum = 0;
+		u32_t timeoutQueryNum = 0;
+		u32_t unknownQueryNum = 0;
+		u32_t skippedQueryNum = 0;	/// queries not sent to Z3 as a budget was exhausted
+		double solveTime = 0;	/// seconds spent in Z3 on the queries of checkQuery
+		u32_t unknownVerdictNum = 0;	/// assertions left undecided
+		///@}
+
+		/// What popEdge restores besides the solver scope
+		struct SolverScope {
+			CallStack callingCtx;
+			z3::expr memModel;
+			u32_t branchNum;	/// number of branch edges on the prefix before this edge
+		};
+		std::vector<SolverScope> scopes;
 
 	 protected:
 		SVFIR* svfir;
@@ -0,0 +1,119 @@
+//===- SSEOptions.cpp -- Command-line options for static symbolic execution --//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2022>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+/*
+ * Command-line options for static symbolic execution
+ *
+ * Created on: Feb 19, 2024
+ */
+
+#include "SSEOptions.h"
+
+using namespace SVF;
+
+const Option<bool> SSEOptions::StreamPaths(
+    "sse-stream-paths",
+    "Translate and check each path once it is collected, keeping only counters and failing paths",
+    false);
+
+const Option<std::string> SSEOptions::PathLog(
+    "sse-path-log",
+    "File to which collected paths are appended in streaming mode",
+    "");
+
+const Option<bool> SSEOptions::Incremental(
+    "sse-incremental",
+    "Push a solver scope per ICFG edge during traversal and pop it on backtracking",
+    false);
+
+const Option<std::string> SSEOptions::PruneMode(
+    "sse-prune",
+    "Check path feasibility during traversal at: none, branch (every branch), every-n (every N branches) or loop-exit",
+    "none");
+
+const Option<u32_t> SSEOptions::PruneInterval("sse-prune-interval", "N for -sse-prune=every-n", 4);
+
+const Option<std::string> SSEOptions::Encoding(
+    "sse-encoding",
+    "Encoding of program values: int (unbounded integers), bv32 or bv64 (bit-vectors of 32/64 bits)",
+    "int");
+
+const Option<std::string> SSEOptions::Tactics(
+    "sse-tactics",
+    "Comma-separated Z3 tactics applied in sequence to build the solver (e.g., simplify,solve-eqs,bit-blast,sat)",
+    "");
+
+const Option<u32_t> SSEOptions::Threads(
+    "sse-threads",
+    "Number of threads checking the collected paths, each with its own Z3 context (1 means sequential)",
+    1);
+
+const Option<u32_t> SSEOptions::QueryTimeout(
+    "sse-timeout",
+    "Timeout in milliseconds of each solver query, a query running out of it yields unknown (0 means no timeout)",
+    0);
+
+const Option<u32_t> SSEOptions::QueryRLimit(
+    "sse-rlimit",
+    "Z3 resource limit of each solver query, a query running out of it yields unknown (0 means no limit)",
+    0);
+
+const Option<u32_t> SSEOptions::AssertBudget(
+    "sse-assert-budget",
+    "Wall-clock seconds for traversing and checking the paths to one assertion (0 means no budget)",
+    0);
+
+const Option<u32_t> SSEOptions::Budget(
+    "sse-budget",
+    "Wall-clock seconds for the whole analysis, queries after it is exhausted yield unknown (0 means no budget)",
+    0);
+
+const Option<bool> SSEOptions::QueryCache(
+    "sse-query-cache",
+    "Cache assertion queries by their simplified constraint sets and reuse results of equal, subset and superset queries",
+    false);
+
+const Option<u32_t> SSEOptions::QueryCacheSize(
+    "sse-query-cache-size",
+    "Maximum number of queries kept by -sse-query-cache, evicting the least recently used (0 means unbounded)",
+    4096);
+
+const Option<bool> SSEOptions::Slice(
+    "sse-slice",
+    "Only send the path constraints sharing variables (transitively) with the assertion to Z3",
+    false);
+
+const Option<u32_t> SSEOptions::Unroll(
+    "sse-unroll",
+    "Number of times a path may take the back edge of a loop per entry to the loop (0 means each loop once)",
+    0);
+
+const Option<bool> SSEOptions::MergeLoops(
+    "sse-merge-loops",
+    "Merge the symbolic states of the paths reaching a loop head at the same iteration (requires -sse-unroll)",
+    false);
+
+const Option<bool> SSEOptions::Merge(
+    "sse-merge",
+    "Merge the symbolic states of the paths from a branch at its immediate post-dominator using ite expressions",
+    false);
+
+const Option<bool> SSEOptions::PrintStat("sse-stat", "Print the statistics of static symbolic execution", false);
@@ -0,0 +1,80 @@
+//===- SSEOptions.h -- Command-line options for static symbolic execution --//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2022>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+/*
+ * Command-line options for static symbolic execution
+ *
+ * Created on: Feb 19, 2024
+ */
+
+#ifndef SOFTWARE_SECURITY_ANALYSIS_SSEOPTIONS_H
+#define SOFTWARE_SECURITY_ANALYSIS_SSEOPTIONS_H
+
+#include "Util/CommandLine.h"
+
+namespace SVF {
+
+	/// Options of the static symbolic execution (ass2), parsed together with SVF's own options
+	class SSEOptions {
+	 public:
+		SSEOptions() = delete;
+
+		/// Check each path as soon as it is collected and drop it afterwards instead of keeping it in `paths`
+		static const Option<bool> StreamPaths;
+		/// Append every collected path to this file (streaming mode only, empty means no spill)
+		static const Option<std::string> PathLog;
+		/// Keep one solver scope per edge of the current path and reuse it for all paths sharing the prefix
+		static const Option<bool> Incremental;
+		/// When to check the feasibility of a path prefix at branch edges: none, branch, every-n or loop-exit
+		static const Option<std::string> PruneMode;
+		/// Check every N-th branch of a path when PruneMode is every-n
+		static const Option<u32_t> PruneInterval;
+		/// Encoding of values: int (unbounded integers), bv32 or bv64 (bit-vectors)
+		static const Option<std::string> Encoding;
+		/// Comma-separated Z3 tactics to build the solver from, e.g., simplify,solve-eqs,bit-blast,sat
+		static const Option<std::string> Tactics;
+		/// Number of threads checking the collected paths, each with its own Z3 context (1 means sequential)
+		static const Option<u32_t> Threads;
+		/// Timeout in milliseconds and resource limit of each solver query (0 means no bound)
+		static const Option<u32_t> QueryTimeout;
+		static const Option<u32_t> QueryRLimit;
+		/// Wall-clock budgets in seconds for the paths to one assertion and for the whole analysis (0 means no bound)
+		static const Option<u32_t> AssertBudget;
+		static const Option<u32_t> Budget;
+		/// Reuse the results of assertion queries with the same, a subset or a superset of constraints
+		static const Option<bool> QueryCache;
+		/// Maximum number of queries kept by the query cache, least recently used first out (0 means unbounded)
+		static const Option<u32_t> QueryCacheSize;
+		/// Only send the constraints sharing variables with the assertion to Z3
+		static const Option<bool> Slice;
+		/// Number of times a path may take the back edge of a loop per entry to the loop (0 means once, via `visited`)
+		static const Option<u32_t> Unroll;
+		/// Merge the states of the paths reaching a loop head at the same iteration (needs -sse-unroll)
+		static const Option<bool> MergeLoops;
+		/// Merge the states of the paths from a branch at the branch's immediate post-dominator
+		static const Option<bool> Merge;
+		/// Print the statistics of the analysis
+		static const Option<bool> PrintStat;
+	};
+
+} // namespace SVF
+
+#endif // SOFTWARE_SECURITY_ANALYSIS_SSEOPTIONS_H
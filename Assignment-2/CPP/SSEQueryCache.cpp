@@ -0,0 +1,244 @@
+//===- SSEQueryCache.cpp -- Cache of solver queries for symbolic execution --//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2022>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+/*
+ * Cache of solver queries for symbolic execution
+ *
+ * Created on: Feb 19, 2024
+ */
+
+#include "SSEQueryCache.h"
+#include <algorithm>
+#include <iomanip>
+
+using namespace SVF;
+using namespace z3;
+
+bool SSEQueryCache::canonicalize(const expr_vector& assertions, expr_vector& constraints) {
+	std::vector<expr> worklist;
+	for (u32_t i = 0; i < assertions.size(); i++)
+		worklist.push_back(assertions[i].simplify());
+	Map<u32_t, expr> conjuncts;
+	while (!worklist.empty()) {
+		expr e = worklist.back();
+		worklist.pop_back();
+		if (e.is_true())
+			continue;
+		if (e.is_false())
+			return false;
+		if (e.is_and()) {
+			for (u32_t i = 0; i < e.num_args(); i++)
+				worklist.push_back(e.arg(i));
+			continue;
+		}
+		conjuncts.emplace(e.id(), e);
+	}
+	std::vector<u32_t> ids;
+	for (const auto& it : conjuncts)
+		ids.push_back(it.first);
+	std::sort(ids.begin(), ids.end());
+	for (u32_t id : ids)
+		constraints.push_back(conjuncts.at(id));
+	return true;
+}
+
+SSEQueryCache::Key SSEQueryCache::getKey(const expr_vector& constraints) {
+	Key key;
+	for (u32_t i = 0; i < constraints.size(); i++)
+		key.push_back(constraints[i].id());
+	return key;
+}
+
+void SSEQueryCache::collectVars(const expr& e, Set<u32_t>& vars, Set<u32_t>& visited) {
+	if (!e.is_app() || !visited.insert(e.id()).second)
+		return;
+	if (e.is_const() && e.decl().decl_kind() == Z3_OP_UNINTERPRETED)
+		vars.insert(e.id());
+	for (u32_t i = 0; i < e.num_args(); i++)
+		collectVars(e.arg(i), vars, visited);
+}
+
+void SSEQueryCache::slice(const expr_vector& constraints, const expr& target, expr_vector& sliced) {
+	std::vector<Set<u32_t>> varsOf(constraints.size());
+	for (u32_t i = 0; i < constraints.size(); i++) {
+		Set<u32_t> visited;
+		collectVars(constraints[i], varsOf[i], visited);
+	}
+	Set<u32_t> relevant;
+	Set<u32_t> visited;
+	collectVars(target, relevant, visited);
+
+	// grow the set of relevant variables until no remaining constraint shares one with it
+	std::vector<bool> kept(constraints.size(), false);
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (u32_t i = 0; i < constraints.size(); i++) {
+			if (kept[i])
+				continue;
+			bool shared = varsOf[i].empty();
+			for (u32_t var : varsOf[i]) {
+				if (relevant.count(var)) {
+					shared = true;
+					break;
+				}
+			}
+			if (shared) {
+				kept[i] = true;
+				relevant.insert(varsOf[i].begin(), varsOf[i].end());
+				changed = true;
+			}
+		}
+	}
+	for (u32_t i = 0; i < constraints.size(); i++) {
+		if (kept[i])
+			sliced.push_back(constraints[i]);
+	}
+}
+
+/// Subset and superset candidates are looked up in the indexes of the query's conjuncts rather than among all
+/// cached queries, and models are only tried from the most recently used entries, so a lookup does not grow with the
+/// number of queries solved so far
+check_result SSEQueryCache::lookup(const Key& key, const expr_vector& constraints, model& m) {
+	auto it = exactResults.find(key);
+	if (it != exactResults.end()) {
+		exactHit++;
+		Entry& entry = entries.at(it->second);
+		touch(entry);
+		if (!entry.sat)
+			return unsat;
+		m = entry.model;
+		return sat;
+	}
+	// keys are sorted, so subsets are checked with std::includes
+	for (u32_t conjunct : key) {
+		auto bucket = unsatByFirst.find(conjunct);
+		if (bucket == unsatByFirst.end())
+			continue;
+		for (u32_t id : bucket->second) {
+			Entry& entry = entries.at(id);
+			if (std::includes(key.begin(), key.end(), entry.key.begin(), entry.key.end())) {
+				subsetUnsatHit++;
+				touch(entry);
+				return unsat;
+			}
+		}
+	}
+	// a superset contains every conjunct of the query, so the smallest bucket among them is scanned
+	const Set<u32_t>* candidates = nullptr;
+	for (u32_t conjunct : key) {
+		auto bucket = satByConjunct.find(conjunct);
+		if (bucket == satByConjunct.end()) {
+			candidates = nullptr;
+			break;
+		}
+		if (candidates == nullptr || bucket->second.size() < candidates->size())
+			candidates = &bucket->second;
+	}
+	if (candidates) {
+		for (u32_t id : *candidates) {
+			Entry& entry = entries.at(id);
+			if (std::includes(entry.key.begin(), entry.key.end(), key.begin(), key.end())) {
+				supersetSatHit++;
+				m = entry.model;
+				touch(entry);
+				return sat;
+			}
+		}
+	}
+	u32_t tried = 0;
+	for (auto pos = lru.begin(); pos != lru.end() && tried < ModelReuseWindow; ++pos) {
+		Entry& entry = entries.at(*pos);
+		if (!entry.sat)
+			continue;
+		tried++;
+		bool satisfied = true;
+		for (u32_t i = 0; i < constraints.size() && satisfied; i++)
+			satisfied = entry.model.eval(constraints[i], true).is_true();
+		if (satisfied) {
+			modelReuseHit++;
+			m = entry.model;
+			touch(entry);
+			return sat;
+		}
+	}
+	miss++;
+	return unknown;
+}
+
+void SSEQueryCache::insert(const Key& key, const expr_vector& constraints, check_result result, const model& m) {
+	if (result == unknown || exactResults.count(key))
+		return;
+	u32_t id = nextID++;
+	lru.push_front(id);
+	entries.emplace(id, Entry{key, constraints, result == sat, m, lru.begin()});
+	exactResults[key] = id;
+	if (result == unsat) {
+		if (!key.empty())
+			unsatByFirst[key.front()].insert(id);
+	}
+	else {
+		for (u32_t conjunct : key)
+			satByConjunct[conjunct].insert(id);
+	}
+	while (capacity > 0 && entries.size() > capacity)
+		evict(lru.back());
+}
+
+void SSEQueryCache::touch(Entry& entry) {
+	lru.splice(lru.begin(), lru, entry.lruPos);
+}
+
+void SSEQueryCache::evict(u32_t id) {
+	auto it = entries.find(id);
+	assert(it != entries.end() && "evicting an entry not in the cache?");
+	const Entry& entry = it->second;
+	if (!entry.sat) {
+		if (!entry.key.empty()) {
+			auto bucket = unsatByFirst.find(entry.key.front());
+			bucket->second.erase(id);
+			if (bucket->second.empty())
+				unsatByFirst.erase(bucket);
+		}
+	}
+	else {
+		for (u32_t conjunct : entry.key) {
+			auto bucket = satByConjunct.find(conjunct);
+			bucket->second.erase(id);
+			if (bucket->second.empty())
+				satByConjunct.erase(bucket);
+		}
+	}
+	exactResults.erase(entry.key);
+	lru.erase(entry.lruPos);
+	entries.erase(it);
+	evicted++;
+}
+
+void SSEQueryCache::printStat() const {
+	SVFUtil::outs().flags(std::ios::left);
+	SVFUtil::outs() << std::setw(25) << "#Query exact hits" << exactHit << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Query subset unsat" << subsetUnsatHit << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Query superset sat" << supersetSatHit << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Query model reuse" << modelReuseHit << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Query cache misses" << miss << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Query cache evictions" << evicted << "\n";
+}
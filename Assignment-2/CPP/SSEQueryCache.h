@@ -0,0 +1,111 @@
+//===- SSEQueryCache.h -- Cache of solver queries for symbolic execution --//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2022>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+/*
+ * Cache of solver queries for symbolic execution
+ *
+ * Created on: Feb 19, 2024
+ */
+
+#ifndef SOFTWARE_SECURITY_ANALYSIS_SSEQUERYCACHE_H
+#define SOFTWARE_SECURITY_ANALYSIS_SSEQUERYCACHE_H
+
+#include "SVFIR/SVFIR.h"
+#include "z3++.h"
+#include <list>
+
+namespace SVF {
+
+	/// Results of solver queries keyed by their canonical constraint sets (KLEE-style counterexample cache).
+	/// Expressions are hash-consed by Z3, so a constraint set is identified by the sorted AST ids of its
+	/// simplified conjuncts, which only makes sense within one z3::context (one cache per Z3SSEMgr).
+	class SSEQueryCache {
+	 public:
+		typedef std::vector<u32_t> Key;
+
+		/// Flatten the assertions into simplified top-level conjuncts, drop `true`s and duplicates and sort them by
+		/// AST id. Return false if a conjunct simplifies to `false`, i.e., the query is trivially unsat
+		static bool canonicalize(const z3::expr_vector& assertions, z3::expr_vector& constraints);
+
+		/// Return the key of canonical constraints
+		static Key getKey(const z3::expr_vector& constraints);
+
+		/// Keep the constraints sharing variables, directly or transitively, with the target (independent-constraint
+		/// slicing). Ground constraints are always kept
+		static void slice(const z3::expr_vector& constraints, const z3::expr& target, z3::expr_vector& sliced);
+
+		/// Keep at most `capacity` queries, evicting the least recently used one (0 means unbounded)
+		explicit SSEQueryCache(u32_t capacity = 0) : capacity(capacity) {}
+
+		/// Return the cached result of a query, or z3::unknown on a miss. Besides an exact match, a query is unsat if
+		/// a subset of it is unsat, and sat if a superset of it is sat or a recently used model satisfies all its
+		/// constraints, in which case that model is returned
+		z3::check_result lookup(const Key& key, const z3::expr_vector& constraints, z3::model& model);
+
+		/// Cache a solved query (model is only used if the result is sat)
+		void insert(const Key& key, const z3::expr_vector& constraints, z3::check_result result, const z3::model& model);
+
+		void printStat() const;
+
+	 private:
+		/// Collect the uninterpreted constants of an expression
+		static void collectVars(const z3::expr& e, Set<u32_t>& vars, Set<u32_t>& visited);
+
+		/// A cached query. Z3 recycles the ids of freed ASTs, so the constraints of the key are kept alive with it
+		struct Entry {
+			Key key;
+			z3::expr_vector constraints;
+			bool sat;
+			z3::model model;
+			std::list<u32_t>::iterator lruPos;
+		};
+
+		/// Move an entry to the front of the LRU list
+		void touch(Entry& entry);
+		/// Drop an entry and its index entries
+		void evict(u32_t id);
+
+		/// Number of most recently used entries whose models are tried on a query
+		static constexpr u32_t ModelReuseWindow = 16;
+
+		u32_t capacity;
+		u32_t nextID = 0;
+		Map<u32_t, Entry> entries;
+		Map<Key, u32_t> exactResults;
+		std::list<u32_t> lru;	/// entry ids, most recently used first
+		/// Unsat entries by the smallest conjunct of their keys: an unsat subset of a query is among the entries of
+		/// the query's conjuncts
+		Map<u32_t, Set<u32_t>> unsatByFirst;
+		/// Sat entries by each conjunct of their keys: a sat superset of a query is among the entries of any of the
+		/// query's conjuncts
+		Map<u32_t, Set<u32_t>> satByConjunct;
+
+		u32_t exactHit = 0;
+		u32_t subsetUnsatHit = 0;
+		u32_t supersetSatHit = 0;
+		u32_t modelReuseHit = 0;
+		u32_t miss = 0;
+		u32_t evicted = 0;
+	};
+
+} // namespace SVF
+
+#endif // SOFTWARE_SECURITY_ANALYSIS_SSEQUERYCACHE_H
@@ -36,9 +36,18 @@ using namespace SVFUtil;
 using namespace llvm;
 using namespace z3;
 
-Z3SSEMgr::Z3SSEMgr(SVFIR* ir)
-: Z3Mgr(ir->getPAGNodeNum() * 10)
-, svfir(ir) {
+std::shared_mutex Z3SSEMgr::svfirMutex;
+
+Z3SSEMgr::Z3SSEMgr(SVFIR* ir, u32_t bvWidth)
+: Z3Mgr(ir->getPAGNodeNum() * 10, bvWidth)
+, svfir(ir)
+, lastCtxID(0) {
+	ctxToID[lastCtx] = lastCtxID;
+}
+
+const SVFVar* Z3SSEMgr::getSVFVar(NodeID id) const {
+	std::shared_lock<std::shared_mutex> lock(svfirMutex);
+	return svfir->getGNode(id);
 }
 
 
@@ -48,20 +57,29 @@ Z3SSEMgr::Z3SSEMgr(SVFIR* ir)
  * Locations includes pointers to globals, heaps, stacks
  */
 z3::expr Z3SSEMgr::createExprForObjVar(const ObjVar* objVar) {
+	if (isZ3ExprSet(objVar->getId())) {
+		objExprCacheHit++;
+		return Z3Mgr::getZ3Expr(objVar->getId());
+	}
+	objExprCacheMiss++;
 	std::string str;
 	raw_string_ostream rawstr(str);
 	expr e(ctx);
-	const BaseObjVar* obj = svfir->getBaseObject(objVar->getId());
+	const BaseObjVar* obj;
+	{
+		std::shared_lock<std::shared_mutex> lock(svfirMutex);
+		obj = svfir->getBaseObject(objVar->getId());
+	}
 	/// constant data
 	if (obj->isConstDataOrAggData() || obj->isConstantArray() || obj->isConstantStruct()) {
 		if (const ConstIntObjVar* consInt = SVFUtil::dyn_cast<ConstIntObjVar>(objVar)) {
-			e = ctx.int_val((s32_t)consInt->getSExtValue());
+			e = getNumeral((s32_t)consInt->getSExtValue());
 		}
 		else if (const ConstFPObjVar* consFp = SVFUtil::dyn_cast<ConstFPObjVar>(objVar)) {
-			e = ctx.int_val(static_cast<u32_t>(consFp->getFPValue()));
+			e = getNumeral(static_cast<u32_t>(consFp->getFPValue()));
 		}
 		else if (SVFUtil::isa<GlobalObjVar>(objVar)) {
-			e = ctx.int_val(getVirtualMemAddress(objVar->getId()));
+			e = getNumeral(getVirtualMemAddress(objVar->getId()));
 		}
 		else if (obj->isConstantArray() || obj->isConstantStruct()) {
 			assert(false && "implement this part");
@@ -73,8 +91,9 @@ z3::expr Z3SSEMgr::createExprForObjVar(const ObjVar* objVar) {
 	}
 	/// locations (address-taken variables)
 	else {
-		e = ctx.int_val(getVirtualMemAddress(objVar->getId()));
+		e = getNumeral(getVirtualMemAddress(objVar->getId()));
 	}
+	updateZ3Expr(objVar->getId(), e);
 	return e;
 }
 
@@ -89,18 +108,43 @@ std::string Z3SSEMgr::callingCtxToStr(const CallStack& callingCtx) {
 	return rawstr.str();
 }
 
+u32_t Z3SSEMgr::getCallingCtxID(const CallStack& callingCtx) {
+	if (callingCtx == lastCtx)
+		return lastCtxID;
+	auto it = ctxToID.find(callingCtx);
+	if (it == ctxToID.end())
+		it = ctxToID.emplace(callingCtx, ctxToID.size()).first;
+	lastCtx = callingCtx;
+	lastCtxID = it->second;
+	return lastCtxID;
+}
+
 z3::expr Z3SSEMgr::getZ3Expr(SVF::u32_t idx, const CallStack& callingCtx) {
 	u32_t varId = getInternalID(idx);
 	assert(varId == idx && "SVFVar idx overflow > 0x7f000000?");
+	// context-free variables are kept in the pre-sized varID2ExprMap
+	if (isZ3ExprSet(varId)) {
+		exprCacheHit++;
+		return Z3Mgr::getZ3Expr(varId);
+	}
+	std::pair<u32_t, u32_t> key(varId, getCallingCtxID(callingCtx));
+	auto it = ctxExprCache.find(key);
+	if (it != ctxExprCache.end()) {
+		exprCacheHit++;
+		return it->second;
+	}
+	exprCacheMiss++;
+
 	std::string str;
 	std::stringstream rawstr(str);
-	const SVFVar *svfVar = svfir->getGNode(varId);
+	const SVFVar *svfVar = getSVFVar(varId);
 	if (const ObjVar* objVar = SVFUtil::dyn_cast<ObjVar>(svfVar)) {
 		return createExprForObjVar(objVar);
 	} else {
 
 		// Check if svfVar does not have a value or it has a constant value
-		if (!SVFUtil::isa<ConstDataValVar, ConstDataObjVar>(svfVar)) {
+		bool ctxFree = SVFUtil::isa<ConstDataValVar, ConstDataObjVar>(svfVar);
+		if (!ctxFree) {
 			// If there is a non-constant value, add callingCtx to z3 expr
 			rawstr << callingCtxToStr(callingCtx);
 		} else {
@@ -108,26 +152,78 @@ z3::expr Z3SSEMgr::getZ3Expr(SVF::u32_t idx, const CallStack& callingCtx) {
 		}
 		rawstr << "ValVar" << varId;
 		std::string name = rawstr.str();
-		return ctx.int_const(name.c_str());
+		z3::expr e = getConst(name.c_str());
+		if (ctxFree)
+			updateZ3Expr(varId, e);
+		else
+			ctxExprCache.emplace(key, e);
+		exprToVar.emplace(e.id(), std::make_pair(varId, ctxFree ? 0 : key.second));
+		return e;
+	}
+}
+
+/// Return the expression of a binary operation under the current encoding.
+/// Bitwise operations over Int are computed via 32-bit vectors; the bit-vector encoding uses them directly
+z3::expr Z3SSEMgr::getBinaryExpr(u32_t opcode, const z3::expr& op0, const z3::expr& op1) {
+	switch (opcode) {
+	case BinaryOperator::Add: return op0 + op1;
+	case BinaryOperator::Sub: return op0 - op1;
+	case BinaryOperator::Mul: return op0 * op1;
+	case BinaryOperator::SDiv: return op0 / op1;
+	case BinaryOperator::SRem: return isBVEncoding() ? z3::srem(op0, op1) : op0 % op1;
+	default: break;
+	}
+	if (isBVEncoding()) {
+		switch (opcode) {
+		case BinaryOperator::Xor: return op0 ^ op1;
+		case BinaryOperator::And: return op0 & op1;
+		case BinaryOperator::Or: return op0 | op1;
+		case BinaryOperator::AShr: return z3::ashr(op0, op1);
+		case BinaryOperator::Shl: return z3::shl(op0, op1);
+		default: break;
+		}
+	}
+	else {
+		switch (opcode) {
+		case BinaryOperator::Xor: return bv2int(int2bv(32, op0) ^ int2bv(32, op1), 1);
+		case BinaryOperator::And: return bv2int(int2bv(32, op0) & int2bv(32, op1), 1);
+		case BinaryOperator::Or: return bv2int(int2bv(32, op0) | int2bv(32, op1), 1);
+		case BinaryOperator::AShr: return bv2int(ashr(int2bv(32, op0), int2bv(32, op1)), 1);
+		case BinaryOperator::Shl: return bv2int(shl(int2bv(32, op0), int2bv(32, op1)), 1);
+		default: break;
+		}
 	}
+	assert(false && "implement this part");
+	abort();
 }
 
 /// Return the address expr of a ObjVar
 z3::expr Z3SSEMgr::getMemObjAddress(u32_t idx) {
 	NodeID objIdx = getInternalID(idx);
-	assert(SVFUtil::isa<ObjVar>(svfir->getGNode(objIdx)) && "Fail to get the MemObj!");
-	return createExprForObjVar(SVFUtil::cast<ObjVar>(svfir->getGNode(objIdx)));
+	assert(SVFUtil::isa<ObjVar>(getSVFVar(objIdx)) && "Fail to get the MemObj!");
+	return createExprForObjVar(SVFUtil::cast<ObjVar>(getSVFVar(objIdx)));
 }
 
 z3::expr Z3SSEMgr::getGepObjAddress(z3::expr pointer, u32_t offset) {
 	NodeID obj = getInternalID(z3Expr2NumValue(pointer));
-	assert(SVFUtil::isa<ObjVar>(svfir->getGNode(obj)) && "Fail to get the base object address!");
-	NodeID gepObj = svfir->getGepObjVar(obj, offset);
-	/// TODO: check whether this node has been created before or not to save creation time
+	assert(SVFUtil::isa<ObjVar>(getSVFVar(obj)) && "Fail to get the base object address!");
+	std::pair<NodeID, u32_t> key(obj, offset);
+	auto it = gepObjCache.find(key);
+	NodeID gepObj;
+	if (it != gepObjCache.end()) {
+		gepObjCacheHit++;
+		gepObj = it->second;
+	}
+	else {
+		gepObjCacheMiss++;
+		std::unique_lock<std::shared_mutex> lock(svfirMutex);
+		gepObj = svfir->getGepObjVar(obj, offset);
+		gepObjCache[key] = gepObj;
+	}
 	if (obj == gepObj)
-		return createExprForObjVar(SVFUtil::cast<ObjVar>(svfir->getGNode(obj)));
+		return createExprForObjVar(SVFUtil::cast<ObjVar>(getSVFVar(obj)));
 	else
-		return createExprForObjVar(SVFUtil::cast<GepObjVar>(svfir->getGNode(gepObj)));
+		return createExprForObjVar(SVFUtil::cast<GepObjVar>(getSVFVar(gepObj)));
 }
 
 s32_t Z3SSEMgr::getGepOffset(const GepStmt* gep, const CallStack& callingCtx) {
@@ -159,58 +255,90 @@ s32_t Z3SSEMgr::getGepOffset(const GepStmt* gep, const CallStack& callingCtx) {
 	return totalOffset;
 }
 
-void Z3SSEMgr::printExprValues(const CallStack& callingCtx) {
-	std::cout.flags(std::ios::left);
-	std::cout << "\n-----------SVFVar and Value-----------\n";
-	std::map<std::string, std::string> printValMap;
-	std::map<NodeID, std::string> objKeyMap;
-	std::map<NodeID, std::string> valKeyMap;
-	for (SVFIR::iterator nIter = svfir->begin(); nIter != svfir->end(); ++nIter) {
-		expr e = getEvalExpr(getZ3Expr(nIter->first, callingCtx));
+/// Walk the assertions and the memory model once (as DAGs). Constants created by getZ3Expr are mapped back to
+/// their variables via exprToVar; numerals that are virtual addresses of objects give the objects
+void Z3SSEMgr::collectPathVars(const CallStack& callingCtx, std::map<NodeID, z3::expr>& valVars,
+                               std::set<NodeID>& objVars) {
+	u32_t ctxID = getCallingCtxID(callingCtx);
+	std::vector<expr> worklist;
+	// read the solver directly, as getSolver() would drop the model checked for printing
+	z3::expr_vector assertions = solver.assertions();
+	for (u32_t i = 0; i < assertions.size(); i++)
+		worklist.push_back(assertions[i]);
+	worklist.push_back(getMemModel());
+	Set<u32_t> visited;
+	while (!worklist.empty()) {
+		expr e = worklist.back();
+		worklist.pop_back();
+		if (!e.is_app() || !visited.insert(e.id()).second)
+			continue;
 		if (e.is_numeral()) {
-			NodeID varID = nIter->second->getId();
-			s32_t value = e.get_numeral_int64();
-			std::stringstream exprName;
-			std::stringstream valstr;
-			if (const ValVar* valVar = SVFUtil::dyn_cast<ValVar>(nIter->second)) {
-				exprName << "ValVar" << varID;
-				if (isVirtualMemAddress(value))
-					valstr << "\t Value: " << std::hex << "0x" << value << "\n";
-				else
-					valstr << "\t Value: " << std::dec << value << "\n";
-				printValMap[exprName.str()] = valstr.str();
-				valKeyMap[varID] = exprName.str();
-			}
-			else {
-				exprName << "ObjVar" << varID << std::hex << " (0x" << getVirtualMemAddress(varID) << ") ";
-				if (isVirtualMemAddress(value)) {
-					expr storedValue = getEvalExpr(loadValue(e));
-					if (storedValue.is_numeral()) {
-						s32_t contentValue = z3Expr2NumValue(storedValue);
-						if (isVirtualMemAddress(contentValue))
-							valstr << "\t Value: " << std::hex << "0x" << contentValue << "\n";
-						else
-							valstr << "\t Value: " << std::dec << contentValue << "\n";
-					}
-					else
-						valstr << "\t Value: NULL"
-						       << "\n";
-				}
-				else
-					valstr << "\t Value: NULL"
-					       << "\n";
-				printValMap[exprName.str()] = valstr.str();
-				objKeyMap[varID] = exprName.str();
+			if (e.get_sort().is_int() || e.get_sort().is_bv()) {
+				int64_t value = getNumeralValue(e);
+				NodeID id = getInternalID(value);
+				if (isVirtualMemAddress(value) && svfir->hasGNode(id) && SVFUtil::isa<ObjVar>(getSVFVar(id)))
+					objVars.insert(id);
 			}
+			continue;
 		}
+		auto it = exprToVar.find(e.id());
+		if (it != exprToVar.end() && (it->second.second == 0 || it->second.second == ctxID))
+			valVars.emplace(it->second.first, e);
+		for (u32_t i = 0; i < e.num_args(); i++)
+			worklist.push_back(e.arg(i));
 	}
-	for (auto it = objKeyMap.begin(); it != objKeyMap.end(); ++it) {
-		std::string printKey = it->second;
-		std::cout << std::setw(25) << printKey << printValMap[printKey];
+}
+
+void Z3SSEMgr::printExprValues(const CallStack& callingCtx) {
+	std::cout.flags(std::ios::left);
+	std::cout << "\n-----------SVFVar and Value-----------\n";
+	std::map<NodeID, expr> valVars;
+	std::set<NodeID> objVars;
+	collectPathVars(callingCtx, valVars, objVars);
+	z3::check_result res = checkOnce();
+	if (res != z3::sat) {
+		std::cout << (res == z3::unsat ? "unsatisfied constraints, no values\n" : "undecided constraints, no values\n");
+		std::cout << "-----------------------------------------\n";
+		return;
 	}
-	for (auto it = valKeyMap.begin(); it != valKeyMap.end(); ++it) {
-		std::string printKey = it->second;
-		std::cout << std::setw(25) << printKey << printValMap[printKey];
+	const z3::model& model = getModel();
+	auto printValue = [this](const expr& val) {
+		if (!val.is_numeral()) {
+			std::cout << "\t Value: NULL\n";
+			return;
+		}
+		s32_t value = getNumeralValue(val);
+		if (isVirtualMemAddress(value))
+			std::cout << "\t Value: " << std::hex << "0x" << value << std::dec << "\n";
+		else
+			std::cout << "\t Value: " << std::dec << value << "\n";
+	};
+	for (NodeID objID : objVars) {
+		std::stringstream exprName;
+		exprName << "ObjVar" << objID << std::hex << " (0x" << getVirtualMemAddress(objID) << ") ";
+		std::cout << std::setw(25) << exprName.str();
+		printValue(model.eval(z3::select(getMemModel(), getNumeral(getVirtualMemAddress(objID))), true));
+	}
+	for (const auto& valVar : valVars) {
+		std::stringstream exprName;
+		exprName << "ValVar" << valVar.first;
+		std::cout << std::setw(25) << exprName.str();
+		printValue(model.eval(valVar.second, true));
 	}
 	std::cout << "-----------------------------------------\n";
 }
+
+void Z3SSEMgr::printStat() const {
+	SVFUtil::outs().flags(std::ios::left);
+	SVFUtil::outs() << "\n-----------Z3SSEMgr Statistics-----------\n";
+	SVFUtil::outs() << std::setw(25) << "#Calling contexts" << ctxToID.size() << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Cached ctx exprs" << ctxExprCache.size() << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Expr cache hits" << exprCacheHit << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Expr cache misses" << exprCacheMiss << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Cached obj exprs" << objExprCacheMiss << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Obj expr cache hits" << objExprCacheHit << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Cached gep objs" << gepObjCache.size() << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Gep obj cache hits" << gepObjCacheHit << "\n";
+	SVFUtil::outs() << std::setw(25) << "#Gep obj cache misses" << gepObjCacheMiss << "\n";
+	SVFUtil::outs() << "-----------------------------------------\n";
+}
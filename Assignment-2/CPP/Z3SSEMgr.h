@@ -30,6 +30,10 @@
 
 #include "Z3Mgr.h"
 #include "SVFIR/SVFIR.h"
+#include <map>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
 
 namespace SVF {
 
@@ -41,15 +45,21 @@ namespace SVF {
 	class Z3SSEMgr : public Z3Mgr {
 		typedef std::vector<const ICFGNode*> CallStack;
 	 public:
-		/// Constructor
-		Z3SSEMgr(SVFIR* ir);
+		/// Constructor, values are encoded as Int if bvWidth is 0 and as bit-vectors of bvWidth bits otherwise
+		Z3SSEMgr(SVFIR* ir, u32_t bvWidth = 0);
 
 
 		std::string callingCtxToStr(const CallStack& callingCtx);
 
+		/// Return the interned ID of a calling context (the empty context is 0)
+		u32_t getCallingCtxID(const CallStack& callingCtx);
+
+		/// Return the expression of a variable under a calling context. Expressions are created once and cached:
+		/// context-free variables (constants and objects) in varID2ExprMap, others by (var ID, context ID)
 		z3::expr getZ3Expr(u32_t idx, const CallStack& callingCtx);
 
-		/// Initialize the expr value for each objects (address-taken variables and constants)
+		/// Initialize the expr value for each objects (address-taken variables and constants).
+		/// The expression is created once per object and kept in varID2ExprMap
 		z3::expr createExprForObjVar(const ObjVar* obj);
 
 		/// Return the address expr of a ObjVar
@@ -58,14 +68,54 @@ namespace SVF {
 		/// Return the field address given a pointer points to a struct object and an offset
 		z3::expr getGepObjAddress(z3::expr pointer, u32_t offset);
 
+		/// Return the expression of a BinaryOPStmt's opcode applied to two operands
+		z3::expr getBinaryExpr(u32_t opcode, const z3::expr& op0, const z3::expr& op1);
+
 		/// Return the offset expression of a GepStmt
 		s32_t getGepOffset(const GepStmt* gep, const CallStack& callingCtx);
 
-		/// Dump values of all exprs
+		/// Collect the variables under callingCtx (or context-free) and the objects whose expressions occur in the
+		/// solver's assertions or the memory model, both sorted by ID
+		void collectPathVars(const CallStack& callingCtx, std::map<NodeID, z3::expr>& valVars, std::set<NodeID>& objVars);
+
+		/// Dump values of the variables and objects on the current path (see collectPathVars), all evaluated against
+		/// one model of the solver
 		virtual void printExprValues(const CallStack& callingCtx);
 
+		/// Print the statistics of the expression caches
+		virtual void printStat() const;
+
+		/// Return the SVFVar of an ID under the shared lock of svfirMutex. Code run by parallel SSE workers
+		/// (-sse-threads) looks up SVFIR nodes through here rather than on SVFIR directly
+		const SVFVar* getSVFVar(NodeID id) const;
+
 	 private:
 		SVFIR* svfir;
+
+		/// SVFIR is shared by the managers of parallel SSE workers (-sse-threads) and getGepObjVar may add nodes to it,
+		/// so lookups take the lock shared and field object creation takes it exclusively
+		static std::shared_mutex svfirMutex;
+
+		/// Interned calling contexts, the last one is remembered as consecutive queries mostly share it
+		///@{
+		Map<CallStack, u32_t> ctxToID;
+		CallStack lastCtx;
+		u32_t lastCtxID;
+		///@}
+
+		/// Expressions of context-sensitive variables keyed by (var ID, context ID)
+		Map<std::pair<u32_t, u32_t>, z3::expr> ctxExprCache;
+		/// (var ID, context ID) of the expressions created by getZ3Expr, keyed by Z3 AST id
+		Map<u32_t, std::pair<NodeID, u32_t>> exprToVar;
+		u32_t exprCacheHit = 0;
+		u32_t exprCacheMiss = 0;
+
+		/// Field objects keyed by (base object, offset), to avoid querying SVFIR for the same field again
+		Map<std::pair<NodeID, u32_t>, NodeID> gepObjCache;
+		u32_t gepObjCacheHit = 0;
+		u32_t gepObjCacheMiss = 0;
+		u32_t objExprCacheHit = 0;
+		u32_t objExprCacheMiss = 0;
 	};
 
 } // namespace SVF
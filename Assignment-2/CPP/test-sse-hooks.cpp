@@ -0,0 +1,110 @@
+#include "Assignment_2.h"
+#include "SVF-LLVM/LLVMUtil.h"
+#include "Util/CommandLine.h"
+#include "Util/Options.h"
+#include "WPA/Andersen.h"
+
+using namespace SVF;
+using namespace SVFUtil;
+u32_t SSE::assert_checked = 0;
+
+/// Assertions that no feasible path is expected to reach, e.g., one after a loop that -sse-unroll cuts short
+static const Option<u32_t> ExpectUnreached(
+    "expect-unreached",
+    "Number of assertions expected to be reached on no feasible path (the others must be verified)",
+    0);
+
+/*
+ // Checks of the traversal hooks of SSE under the traversal options, e.g., "ass2-hooks -sse-unroll=3 test4.ll".
+ // The traversal of SSE::reachability (Assignment-2) runs to each assertion as in SSE::analyse. After each
+ // assertion, the driver checks that the traversal undid what it pushed through the hooks (pushEdge/popEdge,
+ // enterLoopEdge/leaveLoopEdge, the merge points and the stashed states) and that checkAssertion verified the
+ // assertion on the paths reaching it, never falsifying it or leaving it undecided.
+ */
+class SSEHookDriver : public SSE {
+ public:
+	SSEHookDriver(SVFIR* s, ICFG* i) : SSE(s, i) {}
+
+	/// Traverse from the entry to each assertion and return false if a traversal or a verdict is not the expected one
+	bool run() {
+		u32_t unreached = 0;
+		for (const ICFGNode* src : identifySources()) {
+			for (const ICFGNode* sink : identifySinks()) {
+				u32_t checked = assert_checked;
+				u32_t failed = getFailedPaths().size();
+				u32_t undecided = getUnknownVerdictNum();
+				const IntraCFGEdge startEdge(nullptr, const_cast<ICFGNode*>(src));
+				reachability(&startEdge, sink);
+				checkPathsInParallel();
+				if (!isTraversalBalanced() || !callstack.empty() || !visited.empty()) {
+					std::cerr << "Unbalanced traversal to " << sink->toString() << std::endl;
+					return false;
+				}
+				resetSolver();
+				failed = getFailedPaths().size() - failed;
+				undecided = getUnknownVerdictNum() - undecided;
+				if (failed > 0 || undecided > 0) {
+					std::cerr << failed << " falsified and " << undecided << " undecided checks of "
+					          << sink->toString() << std::endl;
+					return false;
+				}
+				if (assert_checked == checked)
+					unreached++;
+			}
+		}
+		if (unreached != ExpectUnreached()) {
+			std::cerr << unreached << " assertions reached on no feasible path, expected " << ExpectUnreached()
+			          << std::endl;
+			return false;
+		}
+		return true;
+	}
+};
+
+int main(int argc, char** argv) {
+	int arg_num = 0;
+	int extraArgc = 4;
+	char** arg_value = new char*[argc + extraArgc];
+	for (; arg_num < argc; ++arg_num) {
+		arg_value[arg_num] = argv[arg_num];
+	}
+	std::vector<std::string> moduleNameVec;
+
+	int orgArgNum = arg_num;
+	arg_value[arg_num++] = (char*)"-model-arrays=true";
+	arg_value[arg_num++] = (char*)"-pre-field-sensitive=false";
+	arg_value[arg_num++] = (char*)"-model-consts=true";
+	arg_value[arg_num++] = (char*)"-stat=false";
+	assert(arg_num == (orgArgNum + extraArgc) && "more extra arguments? Change the value of extraArgc");
+
+	moduleNameVec = OptionBase::parseOptions(arg_num,
+	                                         arg_value,
+	                                         "Software-Verification-Teaching Assignment 4 (traversal hooks)",
+	                                         "[options] <input-bitcode...>");
+
+	LLVMModuleSet::getLLVMModuleSet()->buildSVFModule(moduleNameVec);
+
+	SVFIRBuilder builder;
+	SVFIR* svfir = builder.build();
+
+	CallGraph* callgraph = AndersenWaveDiff::createAndersenWaveDiff(svfir)->getCallGraph();
+	builder.updateCallGraph(callgraph);
+
+	ICFG* icfg = svfir->getICFG();
+	icfg->updateCallGraph(callgraph);
+
+	SSEHookDriver* sse = new SSEHookDriver(svfir, icfg);
+	bool passed = sse->run();
+	bool streamed = SSEOptions::StreamPaths() && !sse->getPaths().empty();
+
+	SVF::LLVMModuleSet::releaseLLVMModuleSet();
+	SVF::SVFIR::releaseSVFIR();
+
+	delete[] arg_value;
+	delete sse;
+	if (!passed || streamed) {
+		std::cerr << (streamed ? "Paths kept with -sse-stream-paths!" : "Traversal hooks check failed!") << std::endl;
+		return 1;
+	}
+	return 0;
+}
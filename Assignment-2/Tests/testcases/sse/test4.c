@@ -0,0 +1,14 @@
+#include "stdbool.h"
+// CHECK: ^sat$
+
+extern void svf_assert(bool);
+
+int main(){
+    int x = 0;
+    for (int i = 0; i < 3; i++) {
+        x = x + 2;
+        svf_assert(x == 2 * i + 2);
+    }
+    svf_assert(x == 6);
+    return 0;
+}
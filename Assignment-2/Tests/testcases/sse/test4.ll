@@ -0,0 +1,92 @@
+; ModuleID = './test4.ll'
+source_filename = "./test4.c"
+target datalayout = "e-m:o-i64:64-i128:128-n32:64-S128"
+target triple = "arm64-apple-macosx14.0.0"
+
+; Function Attrs: noinline nounwind ssp uwtable(sync)
+define i32 @main() #0 !dbg !9 {
+entry:
+  call void @llvm.dbg.value(metadata i32 0, metadata !15, metadata !DIExpression()), !dbg !16
+  call void @llvm.dbg.value(metadata i32 0, metadata !17, metadata !DIExpression()), !dbg !19
+  br label %for.cond, !dbg !20
+
+for.cond:                                         ; preds = %for.inc, %entry
+  %x.0 = phi i32 [ 0, %entry ], [ %add, %for.inc ], !dbg !16
+  %i.0 = phi i32 [ 0, %entry ], [ %inc, %for.inc ], !dbg !19
+  call void @llvm.dbg.value(metadata i32 %i.0, metadata !17, metadata !DIExpression()), !dbg !19
+  call void @llvm.dbg.value(metadata i32 %x.0, metadata !15, metadata !DIExpression()), !dbg !16
+  %cmp = icmp slt i32 %i.0, 3, !dbg !21
+  br i1 %cmp, label %for.body, label %for.end, !dbg !23
+
+for.body:                                         ; preds = %for.cond
+  %add = add nsw i32 %x.0, 2, !dbg !24
+  call void @llvm.dbg.value(metadata i32 %add, metadata !15, metadata !DIExpression()), !dbg !16
+  %mul = mul nsw i32 2, %i.0, !dbg !26
+  %add1 = add nsw i32 %mul, 2, !dbg !27
+  %cmp2 = icmp eq i32 %add, %add1, !dbg !28
+  call void @svf_assert(i1 noundef zeroext %cmp2), !dbg !29
+  br label %for.inc, !dbg !30
+
+for.inc:                                          ; preds = %for.body
+  %inc = add nsw i32 %i.0, 1, !dbg !31
+  call void @llvm.dbg.value(metadata i32 %inc, metadata !17, metadata !DIExpression()), !dbg !19
+  br label %for.cond, !dbg !32, !llvm.loop !33
+
+for.end:                                          ; preds = %for.cond
+  %cmp3 = icmp eq i32 %x.0, 6, !dbg !36
+  call void @svf_assert(i1 noundef zeroext %cmp3), !dbg !37
+  ret i32 0, !dbg !38
+}
+
+declare void @svf_assert(i1 noundef zeroext) #1
+
+; Function Attrs: nocallback nofree nosync nounwind speculatable willreturn memory(none)
+declare void @llvm.dbg.value(metadata, metadata, metadata) #2
+
+attributes #0 = { noinline nounwind ssp uwtable(sync) "frame-pointer"="non-leaf" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="apple-m1" "target-features"="+aes,+crc,+crypto,+dotprod,+fp-armv8,+fp16fml,+fullfp16,+lse,+neon,+ras,+rcpc,+rdm,+sha2,+sha3,+sm4,+v8.1a,+v8.2a,+v8.3a,+v8.4a,+v8.5a,+v8a,+zcm,+zcz" }
+attributes #1 = { "frame-pointer"="non-leaf" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="apple-m1" "target-features"="+aes,+crc,+crypto,+dotprod,+fp-armv8,+fp16fml,+fullfp16,+lse,+neon,+ras,+rcpc,+rdm,+sha2,+sha3,+sm4,+v8.1a,+v8.2a,+v8.3a,+v8.4a,+v8.5a,+v8a,+zcm,+zcz" }
+attributes #2 = { nocallback nofree nosync nounwind speculatable willreturn memory(none) }
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!2, !3, !4, !5, !6, !7}
+!llvm.ident = !{!8}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C11, file: !1, producer: "Homebrew clang version 16.0.6", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, splitDebugInlining: false, nameTableKind: None, sysroot: "/Library/Developer/CommandLineTools/SDKs/MacOSX14.sdk", sdk: "MacOSX14.sdk")
+!1 = !DIFile(filename: "test4.c", directory: "/Users/z5489735/2023/0513/Software-Security-Analysis/Assignment-2/Tests/testcases/sse")
+!2 = !{i32 7, !"Dwarf Version", i32 4}
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = !{i32 1, !"wchar_size", i32 4}
+!5 = !{i32 8, !"PIC Level", i32 2}
+!6 = !{i32 7, !"uwtable", i32 1}
+!7 = !{i32 7, !"frame-pointer", i32 1}
+!8 = !{!"Homebrew clang version 16.0.6"}
+!9 = distinct !DISubprogram(name: "main", scope: !10, file: !10, line: 6, type: !11, scopeLine: 6, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !14)
+!10 = !DIFile(filename: "./test4.c", directory: "/Users/z5489735/2023/0513/Software-Security-Analysis/Assignment-2/Tests/testcases/sse")
+!11 = !DISubroutineType(types: !12)
+!12 = !{!13}
+!13 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!14 = !{}
+!15 = !DILocalVariable(name: "x", scope: !9, file: !10, line: 7, type: !13)
+!16 = !DILocation(line: 0, scope: !9)
+!17 = !DILocalVariable(name: "i", scope: !18, file: !10, line: 8, type: !13)
+!18 = distinct !DILexicalBlock(scope: !9, file: !10, line: 8, column: 5)
+!19 = !DILocation(line: 0, scope: !18)
+!20 = !DILocation(line: 8, column: 10, scope: !18)
+!21 = !DILocation(line: 8, column: 23, scope: !22)
+!22 = distinct !DILexicalBlock(scope: !18, file: !10, line: 8, column: 5)
+!23 = !DILocation(line: 8, column: 5, scope: !18)
+!24 = !DILocation(line: 9, column: 15, scope: !25)
+!25 = distinct !DILexicalBlock(scope: !22, file: !10, line: 8, column: 33)
+!26 = !DILocation(line: 10, column: 27, scope: !25)
+!27 = !DILocation(line: 10, column: 31, scope: !25)
+!28 = !DILocation(line: 10, column: 22, scope: !25)
+!29 = !DILocation(line: 10, column: 9, scope: !25)
+!30 = !DILocation(line: 11, column: 5, scope: !25)
+!31 = !DILocation(line: 8, column: 29, scope: !22)
+!32 = !DILocation(line: 8, column: 5, scope: !22)
+!33 = distinct !{!33, !23, !34, !35}
+!34 = !DILocation(line: 11, column: 5, scope: !18)
+!35 = !{!"llvm.loop.mustprogress"}
+!36 = !DILocation(line: 12, column: 18, scope: !9)
+!37 = !DILocation(line: 12, column: 5, scope: !9)
+!38 = !DILocation(line: 13, column: 5, scope: !9)
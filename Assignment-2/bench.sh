@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# Benchmark ass2 over the test cases of Assignment-2
+# Usage: ./bench.sh ["<ass2 options of config 1>" "<ass2 options of config 2>" ...]
+# Without configs, the Int and bit-vector encodings are compared. The last column is the solve time of a config
+# relative to the first config of the same test
+# e.g.   ./bench.sh "" "-sse-incremental"
+#        ./bench.sh "-sse-encoding=int" "-sse-encoding=bv32" "-sse-encoding=bv32 -sse-tactics=simplify,solve-eqs,bit-blast,sat"
+#        ./bench.sh "-sse-threads=1" "-sse-threads=4"
+#        ./bench.sh "" "-sse-query-cache" "-sse-query-cache -sse-slice"
+#        ./bench.sh "-sse-unroll=1" "-sse-unroll=3" "-sse-unroll=3 -sse-merge-loops"
+#        ./bench.sh "-sse-incremental" "-sse-merge"
+# The ass2 binary is taken from $ASS2 (default: bin/ass2 of the project root)
+
+# Locate the ass2 binary and the test cases relative to this script
+script_dir=$(cd "$(dirname "$0")" && pwd)
+ass2=${ASS2:-$script_dir/../bin/ass2}
+tests=$(ls "$script_dir"/Tests/testcases/sse/*.ll)
+
+# Compare the encodings if no configuration is provided
+if [ $# -eq 0 ]; then
+    set -- "-sse-encoding=int" "-sse-encoding=bv32" "-sse-encoding=bv64"
+fi
+
+printf "%-12s %-40s %10s %14s  %-24s %s\n" "Test" "Options" "Time(ms)" "SolveTime(ms)" "Expr cache hits/misses" \
+    "Solve/first"
+for test in $tests; do
+    first=""
+    for options in "$@"; do
+        start=$(date +%s%N)
+        output=$("$ass2" -sse-stat $options "$test" 2>&1)
+        end=$(date +%s%N)
+        hits=$(echo "$output" | awk '/#Expr cache hits/ {print $NF}')
+        misses=$(echo "$output" | awk '/#Expr cache misses/ {print $NF}')
+        solve=$(echo "$output" | awk '/SolveTime\(s\)/ {printf "%.3f", $NF * 1000}')
+        solve=${solve:-0}
+        first=${first:-$solve}
+        ratio=$(awk -v s="$solve" -v f="$first" 'BEGIN {if (f > 0) printf "%.2fx", s / f; else print "-"}')
+        printf "%-12s %-40s %10d %14s  %-24s %s\n" "$(basename "$test" .ll)" "${options:-default}" \
+            $(((end - start) / 1000000)) "$solve" "$hits/$misses" "$ratio"
+    done
+done
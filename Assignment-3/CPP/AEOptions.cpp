@@ -0,0 +1,68 @@
+//===- AEOptions.cpp -- Command-line options for abstract execution --------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2022>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+/*
+ * Command-line options for abstract execution
+ *
+ * Created on: Feb 19, 2024
+ */
+
+#include "AEOptions.h"
+
+using namespace SVF;
+
+const Option<u32_t> AEOptions::DispatchBench(
+    "ae-dispatch-bench",
+    "Time the dispatch of N million statements of the ICFG by dyn_cast chain and by kind-indexed table (0 means off)",
+    0);
+
+const Option<bool> AEOptions::Sparse(
+    "ae-sparse",
+    "Store top-level variables once where they are defined (joined over calling contexts) and propagate only "
+    "address-taken objects along the ICFG",
+    false);
+
+const Option<u32_t> AEOptions::Summaries(
+    "ae-summaries",
+    "Number of input/output summaries kept per function and reused at call sites whose state they cover (0 means off)",
+    0);
+
+const Option<bool> AEOptions::SummaryExact(
+    "ae-summary-exact",
+    "Only reuse a summary whose input equals the state at the call site rather than subsumes it",
+    false);
+
+const Option<bool> AEOptions::WTOWorkList(
+    "ae-wto-worklist",
+    "Handle the nodes of a function in weak topological order, each pending once (false means FIFO order)",
+    true);
+
+const Option<bool> AEOptions::WidenThresholds(
+    "ae-widen-thresholds",
+    "Widen the head of a cycle up to the constants compared in the cycle (and their neighbours) before infinity",
+    false);
+
+const Option<u32_t> AEOptions::NarrowIterations(
+    "ae-narrow",
+    "Maximum number of narrowing iterations of a cycle after widening (0 means narrowing until stable)",
+    0);
+
+const Option<bool> AEOptions::PrintStat("ae-stat", "Print the statistics of abstract execution", false);
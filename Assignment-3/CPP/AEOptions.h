@@ -0,0 +1,60 @@
+//===- AEOptions.h -- Command-line options for abstract execution ----------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2022>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+/*
+ * Command-line options for abstract execution
+ *
+ * Created on: Feb 19, 2024
+ */
+
+#ifndef SOFTWARE_SECURITY_ANALYSIS_AEOPTIONS_H
+#define SOFTWARE_SECURITY_ANALYSIS_AEOPTIONS_H
+
+#include "Util/CommandLine.h"
+
+namespace SVF {
+
+	/// Options of the abstract execution (ass3), parsed together with SVF's own options
+	class AEOptions {
+	 public:
+		AEOptions() = delete;
+
+		/// Time the dispatch of this many million statements of the ICFG before the analysis (0 means no benchmark)
+		static const Option<u32_t> DispatchBench;
+		/// Keep top-level variables in a def table, propagating only address-taken objects along the ICFG
+		static const Option<bool> Sparse;
+		/// Number of summaries kept per function, reused at call sites whose state they cover (0 means no summaries)
+		static const Option<u32_t> Summaries;
+		/// Only reuse a summary whose input equals the state at the call site (precision guard)
+		static const Option<bool> SummaryExact;
+		/// Pop the nodes of a function in WTO order, each once, instead of in FIFO order
+		static const Option<bool> WTOWorkList;
+		/// Widen cycle heads up to the thresholds harvested from the constants compared in the cycle
+		static const Option<bool> WidenThresholds;
+		/// Maximum number of narrowing iterations of a cycle (0 means narrowing until stable)
+		static const Option<u32_t> NarrowIterations;
+		/// Print the statistics of the analysis
+		static const Option<bool> PrintStat;
+	};
+
+} // namespace SVF
+
+#endif // SOFTWARE_SECURITY_ANALYSIS_AEOPTIONS_H
@@ -26,6 +26,7 @@
  */
 
 #include "Assignment_3.h"
+#include "AEOptions.h"
 #include "Util/Options.h"
 #include "Util/WorkList.h"
 
@@ -92,6 +93,14 @@ void AbstractExecution::bufOverflowDetection(const SVF::SVFStmt* stmt) {
  * widening-narrowing iteration to reach fixed points twice: once for widening (to ensure termination)
  * and once for narrowing (to improve precision).
  * 
+ * Each iteration handles the head and then calls widenNarrowHead with the head's state before the iteration.
+ * It widens the head's state with widenState (which applies the cycle's thresholds under -ae-widen-thresholds)
+ * after Options::WidenDelay() iterations, then narrows it, and returns true once the cycle is stable or
+ * AEOptions::NarrowIterations() narrowings were applied. The body is handled after the head in each iteration.
+ * 
+ * Read and update the state after a node with getAbsStateFromTrace (postAbsTrace). The state before a node
+ * (getPreAbsStateFromTrace) is read-only.
+ * 
  * @param cycle The WTO cycle containing ICFG nodes to be processed
  * @return void
  */
@@ -99,10 +108,17 @@ void AbstractExecution::handleICFGCycle(const ICFGCycleWTO* cycle) {
 	const ICFGNode* head = cycle->head()->getICFGNode();
 	bool increasing = true;
 	u32_t iteration = 0;
-	u32_t widen_delay = Options::WidenDelay(); // or use a class member if you have one
+	u32_t narrowings = 0;
 
 	while (true) {
-		/// TODO: your code starts from here
+		auto headState = postAbsTrace.find(head);
+		AbstractState prev = headState != postAbsTrace.end() ? headState->second : AbstractState();
+		/// TODO: your code starts from here (handle the head)
+
+		if (widenNarrowHead(cycle, prev, iteration++, increasing, narrowings))
+			break;
+		/// TODO: your code starts from here (handle the body)
+
 	}
 
 }
@@ -25,10 +25,14 @@
  * Created on: Feb 19, 2024
  */
 #include "Assignment_3_Helper.h"
+#include "StmtDispatcher.h"
 #include "AE/Svfexe/AbsExtAPI.h"
 #include "SVFIR/SVFIR.h"
+#include <deque>
 
 namespace SVF {
+	class AndersenBase;
+
 	/// Abstract Execution class
 	class AbstractExecution {
 	 public:
@@ -38,6 +42,11 @@ namespace SVF {
 
 		virtual void runOnModule(ICFG* icfg);
 
+		/// Use the call graph of a pointer analysis the caller has already run, instead of running Andersen again
+		void setPointerAnalysis(AndersenBase* ander) {
+			pta = ander;
+		}
+
 		static AbstractExecution& getAEInstance()
 		{
 			static AbstractExecution instance;
@@ -53,6 +62,27 @@ namespace SVF {
 		/// Handle state updates for each type of SVF statement
 		virtual void updateAbsState(const SVFStmt* stmt);
 
+		/// The updateStateOn* handlers indexed by statement kind, used by updateAbsState
+		typedef StmtDispatcher<AbstractExecution> AEStmtDispatcher;
+		static const AEStmtDispatcher& getStmtDispatcher();
+
+		/// Lower the statements of all ICFGNodes once into loweredICFG, run over by handleICFGNode
+		void lowerICFG();
+		const LoweredICFG& getLoweredICFG() const {
+			return loweredICFG;
+		}
+
+		/// Sparse mode (-ae-sparse): top-level variables live in a def table instead of the state of every node
+		///@{
+		void initTopLevelUses();
+		void collectBranchVars(const IntraCFGEdge* edge, std::vector<NodeID>& vars) const;
+		void loadTopLevelVars(AbstractState& as, const std::vector<NodeID>& vars) const;
+		bool storeTopLevelVars(const ICFGNode* node, bool all);
+		///@}
+
+		/// Time the dispatch of statements by a dyn_cast chain and by the kind-indexed table (-ae-dispatch-bench)
+		void benchStmtDispatch(u32_t millions);
+
 		/// Fuction used to implement buffer overflow detection
 		virtual void bufOverflowDetection(const SVFStmt* stmt);
 
@@ -82,25 +112,61 @@ namespace SVF {
 		void initWTO();
 
 		/// Path feasiblity handling
+		/// The is*BranchFeasible functions refine `as` in place, leaving it unspecified if the branch is infeasible
 		///@{
+		/// `as` is overwritten by the join of the states of the feasible predecessors
 		bool mergeStatesFromPredecessors(const ICFGNode* curNode, AbstractState& as);
 
 		bool isCmpBranchFeasible(const CmpStmt* cmpStmt, s64_t succ, AbstractState& as);
 		bool isSwitchBranchFeasible(const SVFVar* var, s64_t succ, AbstractState& as);
 		bool isBranchFeasible(const IntraCFGEdge* intraEdge, AbstractState& as);
+		/// A conditional edge is refined on a slice of its source's state, which is then joined as a delta over it
+		void sliceBranchState(const IntraCFGEdge* edge, const AbstractState& src, AbstractState& delta);
+		void joinBranchDelta(AbstractState& as, const AbstractState& src, const AbstractState& delta, bool first);
 		///@}
 
 		/// Handle a call site in the control flow graph
 		void handleCallSite(const CallICFGNode* callnode);
+
+		/// Fixpoint iteration of recursive functions
+		///@{
+		void handleRecursiveCall(const CallICFGNode* callNode, const FunObjVar* callee);
+		bool widenRecursiveEntry(const FunObjVar* fun, AbstractState& as);
+		///@}
+
+		/// Function summaries (-ae-summaries): reuse the analysis of a callee from a covered input state
+		///@{
+		bool applySummary(const CallICFGNode* callNode, const FunObjVar* callee, const AbstractState& input);
+		void recordSummary(const CallICFGNode* callNode, const FunObjVar* callee, const AbstractState& input);
+		///@}
 		bool isExternalCallForAssignment(const SVF::FunObjVar* func);
 
 		/// Handle a function in the ICFG 
 		void handleFunction(const ICFGNode* funEntry);
+		template <typename WorkList>
+		void handleFunction(const ICFGNode* funEntry, WorkList& worklist);
 
 		/// Get the next nodes of a node
-		std::vector<const ICFGNode*> getNextNodes(const ICFGNode* node) const;
+		const std::vector<const ICFGNode*>& getNextNodes(const ICFGNode* node) const;
 		/// Get the next nodes of a cycle
-		std::vector<const ICFGNode*> getNextNodesOfCycle(const ICFGCycleWTO* cycle) const;
+		const std::vector<const ICFGNode*>& getNextNodesOfCycle(const ICFGCycleWTO* cycle) const;
+		/// Build the WTOs of functions before the analysis
+		void buildWTOs(const std::vector<const FunObjVar*>& funs);
+		/// The WTO of a function, built on demand if the function was not reachable from main in the call graph
+		const ICFGWTO* getWTO(const FunObjVar* fun);
+		/// Number the nodes of a WTO and compute the information of its cycles
+		void initFunWTO(const ICFGWTO* wto);
+		/// Compute the next nodes of all nodes (called by initWTO) and of cycles (called by initFunWTO) once
+		///@{
+		void initNextNodes();
+		NodeBS initCycleInfo(const ICFGCycleWTO* cycle);
+		///@}
+
+		/// Widen the state of a cycle's head, with the cycle's thresholds under -ae-widen-thresholds
+		AbstractState widenState(AbstractState& prev, const AbstractState& cur, const ICFGCycleWTO* cycle);
+		/// Widen or narrow the state of a cycle's head after an iteration, and return true once the cycle is stable
+		bool widenNarrowHead(const ICFGCycleWTO* cycle, AbstractState& prev, u32_t iteration, bool& increasing,
+		                     u32_t& narrowings);
 
 		bool handleICFGNode(const ICFGNode* node);
 
@@ -111,6 +177,14 @@ namespace SVF {
 			return postAbsTrace[node];
 		}
 
+		/// Return the abstract state immediately before a handled ICFGNode. States are updated in postAbsTrace
+		/// (getAbsStateFromTrace), the pre state is the input the node was last handled from
+		const AbstractState& getPreAbsStateFromTrace(const ICFGNode* node) const {
+			auto it = preAbsTrace.find(node);
+			assert(it != preAbsTrace.end() && "no pre state, the ICFGNode is not handled yet?");
+			return it->second;
+		}
+
 		/// Update the offset of a GEP (GetElementPtr) object from its base address
 		void updateGepObjOffsetFromBase(AbstractState& as, AddressValue gepAddrs, AddressValue objAddrs, IntervalValue offset);
 
@@ -119,6 +193,9 @@ namespace SVF {
 
 		void ensureAllAssertsValidated();
 
+		/// Print the statistics of the analysis (-ae-stat)
+		void printStat() const;
+
 		/// Destructor
 		virtual ~AbstractExecution() {
 		}
@@ -127,15 +204,88 @@ namespace SVF {
 		/// SVFIR and ICFG
 		SVFIR* svfir;
 		ICFG* icfg;
+		/// Pointer analysis providing the call graph, set by setPointerAnalysis or run by initWTO
+		AndersenBase* pta = nullptr;
 
 		/// Map a function to its corresponding WTO
 		Map<const FunObjVar*, ICFGWTO*> funcToWTO;
+		/// Wall-clock seconds spent building WTOs
+		double wtoTime = 0;
+		/// Index of each ICFGNode (by ID) in the WTO of its function
+		std::vector<u32_t> wtoIndex;
+		/// Next nodes of each ICFGNode (by ID) and of each WTO cycle
+		std::vector<std::vector<const ICFGNode*>> nextNodes;
+		Map<const ICFGCycleWTO*, std::vector<const ICFGNode*>> cycleExits;
+		/// Widening thresholds of each WTO cycle, harvested from the constants compared in it
+		Map<const ICFGCycleWTO*, std::set<s64_t>> cycleThresholds;
+		/// Number of times the head of each WTO cycle was handled
+		Map<const ICFGNode*, u32_t> cycleHeadVisits;
 		/// A set of functions which are involved in recursions
 		Set<const FunObjVar*> recursiveFuns;
+		/// The call graph SCC (its representative node) of each recursive function
+		Map<const FunObjVar*, NodeID> recursionSCC;
+		/// Recursive functions under fixpoint iteration and their passes so far
+		Map<const FunObjVar*, u32_t> recursionPasses;
+		/// Output summary and widened input of the recursive functions
+		Map<const FunObjVar*, AbstractState> recursionOut;
+		Map<const FunObjVar*, AbstractState> recursionEntryIn;
+		/// Whether stub calls are left unchecked, in the passes of a recursion before its summaries converge
+		bool deferStubChecks = false;
+		/// Total passes of fixpoint iteration per recursion SCC
+		Map<NodeID, u32_t> recursionSCCPasses;
 		/// Abstract trace immediately before an ICFGNode.
 		Map<const ICFGNode*, AbstractState> preAbsTrace;
 		/// Abstract trace immediately after an ICFGNode.
 		Map<const ICFGNode*, AbstractState> postAbsTrace;
+		/// Statements of the ICFGNodes lowered before the analysis
+		LoweredICFG loweredICFG;
+		/// Values of the top-level variables at their definitions (sparse mode)
+		Map<NodeID, AbstractValue> topLevelDefs;
+		/// Number of calls to storeTopLevelVars that changed the def table
+		u32_t topLevelDefChangeNum = 0;
+		/// Top-level variables read at each node (sparse mode): the operands of its statements and its actual
+		/// parameters, and the variables the conditional edges into it are refined on
+		///@{
+		Map<const ICFGNode*, std::vector<NodeID>> topLevelUses;
+		Map<const ICFGNode*, std::vector<NodeID>> branchVars;
+		///@}
+		/// Nodes reading each top-level variable, handled again once its definition changes (sparse mode)
+		Map<NodeID, std::vector<const ICFGNode*>> topLevelUsers;
+		/// Users of changed definitions, waiting to be pushed to the worklist of their function
+		Map<const FunObjVar*, std::vector<const ICFGNode*>> pendingUses;
+		/// Number of times a cycle head's definitions were stored, to delay their widening (sparse mode)
+		Map<const ICFGNode*, u32_t> sparseHeadVisits;
+		/// The state entering a function from a call site and the state at its exit
+		struct FunSummary {
+			AbstractState input;
+			AbstractState output;
+			/// Values of the top-level variables read at the return site (sparse mode)
+			Map<NodeID, AbstractValue> retDefs;
+		};
+		/// Summaries of each function, the oldest first
+		Map<const FunObjVar*, std::deque<FunSummary>> funSummaries;
+		u32_t summaryExactHitNum = 0;
+		u32_t summarySubsumedHitNum = 0;
+		u32_t summaryMissNum = 0;
+		u32_t summaryEvictNum = 0;
+		/// Scratch state holding the values of a predecessor's state a conditional edge refines, on which
+		/// mergeStatesFromPredecessors refines the branch condition
+		AbstractState mergeScratch;
+		/// The variables of collectBranchVars by conditional edge
+		Map<const IntraCFGEdge*, std::vector<NodeID>> edgeBranchVars;
+		/// The values of the merged state at the variables and objects of a delta before joinBranchDelta joins it
+		///@{
+		std::vector<std::pair<NodeID, AbstractValue>> deltaVarsBefore;
+		std::vector<std::pair<NodeID, AbstractValue>> deltaObjsBefore;
+		///@}
+
+		/// Statistics of copying abstract states per node visit
+		///@{
+		u32_t nodeVisitNum = 0;
+		u32_t stateCopyNum = 0;
+		u32_t stateMoveNum = 0;
+		u32_t branchDeltaNum = 0;	/// conditional edges refined on a slice of the state instead of a copy
+		///@}
 
 	 private:
 		AbstractExecutionHelper bufOverflowHelper;
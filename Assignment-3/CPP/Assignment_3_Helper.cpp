@@ -26,7 +26,14 @@
  */
 
 #include "Assignment_3.h"
+#include "AEOptions.h"
 #include "WPA/Andersen.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iterator>
+#include <numeric>
+#include <sys/resource.h>
 
 using namespace SVF;
 
@@ -116,8 +123,70 @@ bool AbstractExecution::isExternalCallForAssignment(const SVF::FunObjVar* func)
 void AbstractExecution::runOnModule(SVF::ICFG* _icfg) {
 	svfir = PAG::getPAG();
 	icfg = _icfg;
+	if (AEOptions::DispatchBench())
+		benchStmtDispatch(AEOptions::DispatchBench());
 	analyse();
 	bufOverflowHelper.printReport();
+	if (AEOptions::PrintStat())
+		printStat();
+}
+
+/// Peak resident set size of the process in KB (ru_maxrss is in bytes on macOS and in KB on Linux)
+static long getPeakMemoryKB() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+/// Print the statistics of the analysis
+void AbstractExecution::printStat() const {
+	std::cout.flags(std::ios::left);
+	std::cout << "\n-----------AE Statistics-----------\n";
+	std::cout << std::setw(25) << "#WTOs" << funcToWTO.size() << "\n";
+	std::cout << std::setw(25) << "WTOTime(s)" << wtoTime << "\n";
+	std::cout << std::setw(25) << "#Node visits" << nodeVisitNum << "\n";
+	std::cout << std::setw(25) << "#State copies" << stateCopyNum << "\n";
+	std::cout << std::setw(25) << "#State moves" << stateMoveNum << "\n";
+	std::cout << std::setw(25) << "#Branch deltas" << branchDeltaNum << "\n";
+	std::cout << std::setw(25) << "#Copies per visit" << (nodeVisitNum ? (double)stateCopyNum / nodeVisitNum : 0) << "\n";
+	std::cout << std::setw(25) << "PeakMemory(KB)" << getPeakMemoryKB() << "\n";
+	if (AEOptions::Sparse())
+		std::cout << std::setw(25) << "#Top-level defs" << topLevelDefs.size() << "\n";
+	for (const auto& head : cycleHeadVisits) {
+		if (head.second > 0)
+			std::cout << std::setw(25) << ("#Iterations of cycle " + std::to_string(head.first->getId())) << head.second
+			          << "\n";
+	}
+	for (const auto& scc : recursionSCCPasses)
+		std::cout << std::setw(25) << ("#Passes of SCC " + std::to_string(scc.first)) << scc.second << "\n";
+	if (AEOptions::Summaries()) {
+		std::cout << std::setw(25) << "#Summary exact hits" << summaryExactHitNum << "\n";
+		std::cout << std::setw(25) << "#Summary subsumed hits" << summarySubsumedHitNum << "\n";
+		std::cout << std::setw(25) << "#Summary misses" << summaryMissNum << "\n";
+		std::cout << std::setw(25) << "#Summary evictions" << summaryEvictNum << "\n";
+	}
+	std::cout << "-----------------------------------------\n";
+}
+
+/// Number the nodes of a WTO component in weak topological order, the head of a cycle before its body
+static void numberWTOComp(const ICFGWTOComp* comp, u32_t& index, std::vector<u32_t>& wtoIndex) {
+	auto number = [&](const ICFGNode* node) {
+		if (node->getId() >= wtoIndex.size())
+			wtoIndex.resize(node->getId() + 1, UINT_MAX);
+		wtoIndex[node->getId()] = index++;
+	};
+	if (const ICFGSingletonWTO* singleton = SVFUtil::dyn_cast<ICFGSingletonWTO>(comp))
+		number(singleton->getICFGNode());
+	else if (const ICFGCycleWTO* cycle = SVFUtil::dyn_cast<ICFGCycleWTO>(comp)) {
+		number(cycle->head()->getICFGNode());
+		for (const ICFGWTOComp* inner : cycle->getWTOComponents())
+			numberWTOComp(inner, index, wtoIndex);
+	}
 }
 
 /**
@@ -128,35 +197,78 @@ void AbstractExecution::runOnModule(SVF::ICFG* _icfg) {
  * Any function found to be part of a cycle is marked as recursive.
  */
 void AbstractExecution::initWTO() {
-	AndersenWaveDiff* ander = AndersenWaveDiff::createAndersenWaveDiff(svfir);
+	// Reuse the pointer analysis of the caller if any
+	if (!pta)
+		pta = AndersenWaveDiff::createAndersenWaveDiff(svfir);
 	// Detect if the call graph has cycles by finding its strongly connected components (SCC)
-	Andersen::CallGraphSCC* callGraphScc = ander->getCallGraphSCC();
+	Andersen::CallGraphSCC* callGraphScc = pta->getCallGraphSCC();
 	callGraphScc->find();
-	auto callGraph = ander->getCallGraph();
+	CallGraph* callGraph = pta->getCallGraph();
 
 	// Iterate through the call graph
 	for (auto it = callGraph->begin(); it != callGraph->end(); it++) {
 		// Check if the current function is part of a cycle
-		if (callGraphScc->isInCycle(it->second->getId()))
+		if (callGraphScc->isInCycle(it->second->getId())) {
 			recursiveFuns.insert(it->second->getFunction()); // Mark the function as recursive
+			recursionSCC[it->second->getFunction()] = callGraphScc->repNode(it->second->getId());
+		}
 	}
 
-	// Initialize WTO for each function in the module
-	for (const auto& item : *callGraph) {
-		const FunObjVar* fun = item.second->getFunction();
-		if(fun->isDeclaration())
-			continue;
-		auto* wto = new ICFGWTO(icfg, icfg->getFunEntryICFGNode(fun));
-		wto->init();
-		funcToWTO[fun] = wto;
+	// Initialize WTO for each function reachable from main in the call graph, others are built by getWTO if called
+	std::vector<const FunObjVar*> funs;
+	std::vector<const CallGraphNode*> stack;
+	Set<const CallGraphNode*> reached;
+	if (const FunObjVar* main = svfir->getFunObjVar("main")) {
+		stack.push_back(callGraph->getCallGraphNode(main));
+		reached.insert(stack.back());
 	}
-	for (auto fun: funcToWTO) {
-		for (const ICFGWTOComp* comp : fun.second->getWTOComponents()) {
-			if (const ICFGCycleWTO* cycle = SVFUtil::dyn_cast<ICFGCycleWTO>(comp)) {
-				cycleHeadToCycle[cycle->head()->getICFGNode()] = cycle;
-			}
+	while (!stack.empty()) {
+		const CallGraphNode* node = stack.back();
+		stack.pop_back();
+		if (!node->getFunction()->isDeclaration())
+			funs.push_back(node->getFunction());
+		for (const CallGraphEdge* edge : node->getOutEdges()) {
+			if (reached.insert(edge->getDstNode()).second)
+				stack.push_back(edge->getDstNode());
 		}
 	}
+	buildWTOs(funs);
+	initNextNodes();
+	for (const FunObjVar* fun : funs)
+		initFunWTO(funcToWTO[fun]);
+}
+
+const ICFGWTO* AbstractExecution::getWTO(const FunObjVar* fun) {
+	auto it = funcToWTO.find(fun);
+	if (it != funcToWTO.end())
+		return it->second;
+	buildWTOs({fun});
+	const ICFGWTO* wto = funcToWTO[fun];
+	initFunWTO(wto);
+	return wto;
+}
+
+void AbstractExecution::initFunWTO(const ICFGWTO* wto) {
+	u32_t index = 0;
+	for (const ICFGWTOComp* comp : wto->getWTOComponents())
+		numberWTOComp(comp, index, wtoIndex);
+	for (const ICFGWTOComp* comp : wto->getWTOComponents()) {
+		if (const ICFGCycleWTO* cycle = SVFUtil::dyn_cast<ICFGCycleWTO>(comp)) {
+			cycleHeadToCycle[cycle->head()->getICFGNode()] = cycle;
+			initCycleInfo(cycle);
+		}
+	}
+}
+
+/// Build the WTOs of functions, timing them for -ae-stat
+void AbstractExecution::buildWTOs(const std::vector<const FunObjVar*>& funs) {
+	auto start = std::chrono::steady_clock::now();
+	for (const FunObjVar* fun : funs) {
+		ICFGWTO* wto = new ICFGWTO(icfg, icfg->getFunEntryICFGNode(fun));
+		wto->init();
+		funcToWTO[fun] = wto;
+	}
+	wtoTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 }
 
 /**
@@ -217,26 +329,60 @@ void AbstractExecution::updateGepObjOffsetFromBase(AbstractState& as, SVF::Addre
  */
 bool AbstractExecution::mergeStatesFromPredecessors(const ICFGNode* block, AbstractState& as) {
 	u32_t inEdgeNum = 0; // Initialize the number of incoming edges with feasible states
-	as = AbstractState();
+	// In sparse mode the variables refined by the conditional edges are loaded into every incoming state, so that a
+	// refined value is joined with the unrefined values of the other edges rather than with nothing
+	const std::vector<NodeID>* refined = nullptr;
+	if (AEOptions::Sparse()) {
+		auto vars = branchVars.find(block);
+		if (vars != branchVars.end())
+			refined = &vars->second;
+	}
 	// Iterate over all incoming edges of the given block
 	for (auto& edge : block->getInEdges()) {
 		// Check if the source node of the edge has a post-execution state recorded
-		if (postAbsTrace.find(edge->getSrcNode()) != postAbsTrace.end()) {
+		const AbstractState* srcState = nullptr;
+		const FunObjVar* callee = edge->getSrcNode()->getFun();
+		if (SVFUtil::isa<RetCFGEdge>(edge) && recursionPasses.find(callee) != recursionPasses.end()) {
+			// A return from a function under recursion fixpoint iteration yields its current output summary
+			auto out = recursionOut.find(callee);
+			if (out != recursionOut.end())
+				srcState = &out->second;
+		}
+		else {
+			auto srcIt = postAbsTrace.find(edge->getSrcNode());
+			if (srcIt != postAbsTrace.end())
+				srcState = &srcIt->second;
+		}
+		if (srcState) {
 			const IntraCFGEdge* intraCfgEdge = SVFUtil::dyn_cast<IntraCFGEdge>(edge);
 
 			// If the edge is an intra-block edge and has a condition
 			if (intraCfgEdge && intraCfgEdge->getCondition()) {
-				AbstractState tmpEs = postAbsTrace[edge->getSrcNode()];
+				// Refine the condition on a scratch state holding only the values the branch reads and refines
+				sliceBranchState(intraCfgEdge, *srcState, mergeScratch);
+				if (refined)
+					loadTopLevelVars(mergeScratch, *refined);
 				// Check if the branch condition is feasible
-				if (isBranchFeasible(intraCfgEdge, tmpEs)) {
-					as.joinWith(tmpEs); // Merge the state with the current state
+				if (isBranchFeasible(intraCfgEdge, mergeScratch)) {
+					joinBranchDelta(as, *srcState, mergeScratch, inEdgeNum == 0);
 					inEdgeNum++;
 				}
 				// If branch is not feasible, do nothing
 			}
+			else if (refined) {
+				mergeScratch.clear();
+				loadTopLevelVars(mergeScratch, *refined);
+				joinBranchDelta(as, *srcState, mergeScratch, inEdgeNum == 0);
+				inEdgeNum++;
+			}
 			else {
 				// For non-conditional edges, directly merge the state
-				as.joinWith(postAbsTrace[edge->getSrcNode()]);
+				if (inEdgeNum == 0) {
+					as = *srcState;
+					stateCopyNum++;
+				}
+				else
+					as.joinWith(*srcState);
 				inEdgeNum++;
 			}
 		}
@@ -253,8 +399,79 @@ bool AbstractExecution::mergeStatesFromPredecessors(const ICFGNode* block, Abstr
 	assert(false && "implement this part"); // This part should not be reached
 }
 
+/**
+ * @brief Copy into `delta` the values of `src` a conditional edge reads and refines
+ *
+ * These are the variables of collectBranchVars and the objects their addresses point to, so that the branch is
+ * refined on a few values instead of on a copy of the whole state.
+ */
+void AbstractExecution::sliceBranchState(const IntraCFGEdge* edge, const AbstractState& src, AbstractState& delta) {
+	auto vars = edgeBranchVars.find(edge);
+	if (vars == edgeBranchVars.end()) {
+		vars = edgeBranchVars.emplace(edge, std::vector<NodeID>()).first;
+		collectBranchVars(edge, vars->second);
+	}
+	delta.clear();
+	const AbstractState::VarToAbsValMap& srcVars = src.getVarToVal();
+	const AbstractState::AddrToAbsValMap& srcObjs = src.getLocToVal();
+	for (NodeID id : vars->second) {
+		auto var = srcVars.find(id);
+		if (var == srcVars.end())
+			continue;
+		delta[id] = var->second;
+		if (!var->second.isAddr())
+			continue;
+		for (const auto& addr : var->second.getAddrs()) {
+			auto obj = srcObjs.find(AbstractState::getInternalID(addr));
+			if (obj != srcObjs.end())
+				delta.store(addr, obj->second);
+		}
+	}
+	branchDeltaNum++;
+}
+
+/**
+ * @brief Join `src` refined by `delta` into `as`, without building the refined copy of `src`
+ *
+ * Outside the values of `delta`, the result is `as` joined with `src`; at them, it is `as` joined with `delta`.
+ * The first incoming state (`first`) is copied into `as` and overwritten with `delta`.
+ */
+void AbstractExecution::joinBranchDelta(AbstractState& as, const AbstractState& src, const AbstractState& delta,
+                                        bool first) {
+	if (first) {
+		as = src;
+		stateCopyNum++;
+		for (const auto& item : delta.getVarToVal())
+			as[item.first] = item.second;
+		for (const auto& item : delta.getLocToVal())
+			as.store(AbstractState::getVirtualMemAddress(item.first), item.second);
+		return;
+	}
+	// The values of `as` that the join with `src` would overwrite at the refined variables and objects
+	deltaVarsBefore.clear();
+	deltaObjsBefore.clear();
+	for (const auto& item : delta.getVarToVal()) {
+		if (as.inVarToValTable(item.first) || as.inVarToAddrsTable(item.first))
+			deltaVarsBefore.emplace_back(item.first, as[item.first]);
+	}
+	for (const auto& item : delta.getLocToVal()) {
+		if (as.inAddrToValTable(item.first) || as.inAddrToAddrsTable(item.first))
+			deltaObjsBefore.emplace_back(item.first, as.load(AbstractState::getVirtualMemAddress(item.first)));
+	}
+	as.joinWith(src);
+	for (const auto& item : delta.getVarToVal())
+		as[item.first] = item.second;
+	for (const auto& item : delta.getLocToVal())
+		as.store(AbstractState::getVirtualMemAddress(item.first), item.second);
+	for (const auto& item : deltaVarsBefore)
+		as[item.first].join_with(item.second);
+	for (const auto& item : deltaObjsBefore)
+		as.load(AbstractState::getVirtualMemAddress(item.first)).join_with(item.second);
+}
+
 bool AbstractExecution::isCmpBranchFeasible(const CmpStmt* cmpStmt, s64_t succ, AbstractState& as) {
-	AbstractState new_es = as;
+	// Refine `as` in place, it is a scratch copy that is dropped if the branch is infeasible
+	AbstractState& new_es = as;
 	// get cmp stmt's op0, op1, and predicate
 	NodeID op0 = cmpStmt->getOpVarID(0);
 	NodeID op1 = cmpStmt->getOpVarID(1);
@@ -438,7 +655,8 @@ bool AbstractExecution::isCmpBranchFeasible(const CmpStmt* cmpStmt, s64_t succ,
 }
 
 bool AbstractExecution::isSwitchBranchFeasible(const SVFVar* var, s64_t succ, AbstractState& as) {
-	AbstractState new_es = as;
+	// Refine `as` in place, it is a scratch copy that is dropped if the branch is infeasible
+	AbstractState& new_es = as;
 	IntervalValue& switch_cond = new_es[var->getId()].getInterval();
 	s64_t value = succ;
 	FIFOWorkList<const SVFStmt*> workList;
@@ -543,6 +761,9 @@ void AbstractExecution::ensureAllAssertsValidated() {
 void AbstractExecution::analyse() {
 	// Init WTOs for all functions, and handle Global ICFGNode of SVFModule
 	initWTO();
+	lowerICFG();
+	if (AEOptions::Sparse())
+		initTopLevelUses();
 	utils = new AbsExtAPI(postAbsTrace);
 
 	// Handle the global node
@@ -557,6 +778,8 @@ void AbstractExecution::analyse() {
 		}
 		//assert the main function exist
 		assert(svfir->getFunObjVar("main") != nullptr && "Main function not found");
+		if (AEOptions::Sparse())
+			storeTopLevelVars(icfg->getGlobalICFGNode(), true);
 		handleFunction(svfir->getICFG()->getFunEntryICFGNode(svfir->getFunObjVar("main")));
 	}
 	return;
@@ -575,26 +798,45 @@ void AbstractExecution::analyse() {
  * @return True if the abstract state has changed, false if it has reached a fixpoint or is infeasible
  */
 bool AbstractExecution::handleICFGNode(const ICFGNode* node) {
+	nodeVisitNum++;
+	auto headVisits = cycleHeadVisits.find(node);
+	if (headVisits != cycleHeadVisits.end())
+		headVisits->second++;
 	AbstractState tmpEs;
 	bool is_feasible = mergeStatesFromPredecessors(node, tmpEs);
 	if (!is_feasible) {
 		SVFUtil::errs() << "Infeasible for node " << node->getId() << "\n";
 		return false;
 	}
-	preAbsTrace[node] = tmpEs;
+	// The input of a function under recursion fixpoint iteration is widened across passes
+	if (SVFUtil::isa<FunEntryICFGNode>(node) && !recursionPasses.empty())
+		widenRecursiveEntry(node->getFun(), tmpEs);
+	AbstractState& preAs = preAbsTrace[node];
+	preAs = std::move(tmpEs);
 	// Store the last abstract state, used to check if the abstract state has reached a fixpoint
-	AbstractState last_as = postAbsTrace[node]; 
-	postAbsTrace[node] = preAbsTrace[node];
-	for (const SVFStmt* stmt : node->getSVFStmts()) {
-		updateAbsState(stmt);
-		bufOverflowDetection(stmt);
+	AbstractState& postAs = postAbsTrace[node];
+	AbstractState last_as = std::move(postAs);
+	postAs = preAs;
+	stateMoveNum += 2;
+	stateCopyNum++;
+	if (AEOptions::Sparse()) {
+		auto uses = topLevelUses.find(node);
+		if (uses != topLevelUses.end())
+			loadTopLevelVars(postAs, uses->second);
+	}
+	// Run over the statements lowered by lowerICFG, whose handlers are already resolved
+	for (const LoweredStmt& stmt : loweredICFG.getStmts(node->getId())) {
+		stmt.handler(*this, stmt.stmt);
+		bufOverflowDetection(stmt.stmt);
 	}
 
 	if (const CallICFGNode* callNode = SVFUtil::dyn_cast<CallICFGNode>(node)) {
 			handleCallSite(callNode);
 	}
+	// In sparse mode the node's definitions go to the def table, which may change while the state does not
+	bool defChanged = AEOptions::Sparse() && storeTopLevelVars(node, false);
 	// If the abstract state is the same as the last abstract state, return false because we have reached fixpoint
-	if (postAbsTrace[node] == last_as) {
+	if (!defChanged && postAbsTrace[node] == last_as) {
 		return false;
 	}
 	return true;
@@ -608,60 +850,331 @@ bool AbstractExecution::handleICFGNode(const ICFGNode* node) {
  * @param stmt The SVF statement for which the state needs to be updated
  */
 void AbstractExecution::updateAbsState(const SVFStmt* stmt) {
-	// Handle address statements
-	if (const AddrStmt* addr = SVFUtil::dyn_cast<AddrStmt>(stmt)) {
-		updateStateOnAddr(addr);
-	}
-	// Handle binary operation statements
-	else if (const BinaryOPStmt* binary = SVFUtil::dyn_cast<BinaryOPStmt>(stmt)) {
-		updateStateOnBinary(binary);
-	}
-	// Handle comparison statements
-	else if (const CmpStmt* cmp = SVFUtil::dyn_cast<CmpStmt>(stmt)) {
-		updateStateOnCmp(cmp);
-	}
-	// Handle load statements
-	else if (const LoadStmt* load = SVFUtil::dyn_cast<LoadStmt>(stmt)) {
-		updateStateOnLoad(load);
-	}
-	// Handle store statements
-	else if (const StoreStmt* store = SVFUtil::dyn_cast<StoreStmt>(stmt)) {
-		updateStateOnStore(store);
-	}
-	// Handle copy statements
-	else if (const CopyStmt* copy = SVFUtil::dyn_cast<CopyStmt>(stmt)) {
-		updateStateOnCopy(copy);
+	getStmtDispatcher().dispatch(*this, stmt);
+}
+
+/**
+ * @brief The statement handlers indexed by SVFStmt::getEdgeKind()
+ *
+ * Forks and joins of threads are handled as the calls and returns they are derived from.
+ * UnaryOPStmt needs no handling and BranchStmt is handled in isBranchFeasible.
+ * A kind without a handler asserts "implement this part" when dispatched.
+ */
+const AbstractExecution::AEStmtDispatcher& AbstractExecution::getStmtDispatcher() {
+	static const AEStmtDispatcher dispatcher = []() {
+		AEStmtDispatcher d;
+		d.set<SVFStmt::Addr, AddrStmt, &AbstractExecution::updateStateOnAddr>();
+		d.set<SVFStmt::BinaryOp, BinaryOPStmt, &AbstractExecution::updateStateOnBinary>();
+		d.set<SVFStmt::Cmp, CmpStmt, &AbstractExecution::updateStateOnCmp>();
+		d.set<SVFStmt::Load, LoadStmt, &AbstractExecution::updateStateOnLoad>();
+		d.set<SVFStmt::Store, StoreStmt, &AbstractExecution::updateStateOnStore>();
+		d.set<SVFStmt::Copy, CopyStmt, &AbstractExecution::updateStateOnCopy>();
+		d.set<SVFStmt::Gep, GepStmt, &AbstractExecution::updateStateOnGep>();
+		d.set<SVFStmt::Phi, PhiStmt, &AbstractExecution::updateStateOnPhi>();
+		d.set<SVFStmt::Call, CallPE, &AbstractExecution::updateStateOnCall>();
+		d.set<SVFStmt::ThreadFork, CallPE, &AbstractExecution::updateStateOnCall>();
+		d.set<SVFStmt::Ret, RetPE, &AbstractExecution::updateStateOnRet>();
+		d.set<SVFStmt::ThreadJoin, RetPE, &AbstractExecution::updateStateOnRet>();
+		d.set<SVFStmt::Select, SelectStmt, &AbstractExecution::updateStateOnSelect>();
+		d.ignore(SVFStmt::UnaryOp);
+		d.ignore(SVFStmt::Branch);
+		return d;
+	}();
+	return dispatcher;
+}
+
+/**
+ * @brief Lower the statements of all ICFGNodes before the analysis
+ *
+ * Each statement is stored with the handler of its kind and its result and operand IDs, contiguously per ICFGNode.
+ * The operands are what the sparse mode loads from and stores to the def table.
+ * handleICFGNode runs over these instead of re-dispatching the node's SVFStmts every time it is visited.
+ */
+void AbstractExecution::lowerICFG() {
+	const AEStmtDispatcher& dispatcher = getStmtDispatcher();
+	for (auto it = icfg->begin(); it != icfg->end(); ++it) {
+		loweredICFG.beginNode(it->first);
+		for (const SVFStmt* stmt : it->second->getSVFStmts()) {
+			LoweredStmt& lowered = loweredICFG.addStmt(stmt, dispatcher.getHandler((SVFStmt::PEDGEK)stmt->getEdgeKind()));
+			if (const AssignStmt* assign = SVFUtil::dyn_cast<AssignStmt>(stmt)) {
+				lowered.res = assign->getLHSVarID();
+				loweredICFG.addOperand(assign->getRHSVarID());
+				if (const GepStmt* gep = SVFUtil::dyn_cast<GepStmt>(stmt)) {
+					for (const auto& offsetVarAndType : gep->getOffsetVarAndGepTypePairVec())
+						loweredICFG.addOperand(offsetVarAndType.first->getId());
+				}
+			}
+			else if (const MultiOpndStmt* multi = SVFUtil::dyn_cast<MultiOpndStmt>(stmt)) {
+				lowered.res = multi->getResID();
+				for (u32_t i = 0; i < multi->getOpVarNum(); ++i)
+					loweredICFG.addOperand(multi->getOpVarID(i));
+			}
+		}
 	}
-	// Handle GEP (GetElementPtr) statements
-	else if (const GepStmt* gep = SVFUtil::dyn_cast<GepStmt>(stmt)) {
-		updateStateOnGep(gep);
+}
+
+/**
+ * @brief Index the top-level variables read at each node and the nodes reading each variable (sparse mode)
+ *
+ * A node reads the operands of its statements, the pointer a store writes through and, at a call site, its actual
+ * parameters, which the stub functions and external APIs read from the call site's state. The destination of a
+ * conditional edge also reads the variables the edge is refined on.
+ */
+void AbstractExecution::initTopLevelUses() {
+	for (auto it = icfg->begin(); it != icfg->end(); ++it) {
+		const ICFGNode* node = it->second;
+		std::vector<NodeID> uses;
+		for (const LoweredStmt& stmt : loweredICFG.getStmts(node->getId())) {
+			for (u32_t i = 0; i < stmt.opNum; ++i)
+				uses.push_back(loweredICFG.getOperand(stmt, i));
+			if (stmt.kind == SVFStmt::Store)
+				uses.push_back(stmt.res);
+		}
+		if (const CallICFGNode* callNode = SVFUtil::dyn_cast<CallICFGNode>(node)) {
+			for (const ValVar* arg : callNode->getActualParms())
+				uses.push_back(arg->getId());
+		}
+		std::vector<NodeID> refined;
+		for (const ICFGEdge* edge : node->getInEdges()) {
+			const IntraCFGEdge* intraEdge = SVFUtil::dyn_cast<IntraCFGEdge>(edge);
+			if (intraEdge && intraEdge->getCondition())
+				collectBranchVars(intraEdge, refined);
+		}
+		for (std::vector<NodeID>* vars : {&uses, &refined}) {
+			std::sort(vars->begin(), vars->end());
+			vars->erase(std::unique(vars->begin(), vars->end()), vars->end());
+		}
+		std::vector<NodeID> all;
+		std::set_union(uses.begin(), uses.end(), refined.begin(), refined.end(), std::back_inserter(all));
+		for (NodeID id : all)
+			topLevelUsers[id].push_back(node);
+		if (!uses.empty())
+			topLevelUses.emplace(node, std::move(uses));
+		if (!refined.empty())
+			branchVars.emplace(node, std::move(refined));
 	}
-	// Handle phi statements
-	else if (const PhiStmt* phi = SVFUtil::dyn_cast<PhiStmt>(stmt)) {
-		updateStateOnPhi(phi);
+}
+
+/**
+ * @brief Collect the top-level variables a conditional edge is refined on
+ *
+ * These are the condition and, if it is a comparison, its operands and the pointers they are loaded from,
+ * as read by isCmpBranchFeasible and isSwitchBranchFeasible.
+ */
+void AbstractExecution::collectBranchVars(const IntraCFGEdge* edge, std::vector<NodeID>& vars) const {
+	// The variable and the pointers it is loaded from (through a copy)
+	auto collectWithPointers = [&](const SVFVar* var) {
+		vars.push_back(var->getId());
+		for (const SVFStmt* stmt : var->getInEdges()) {
+			if (const LoadStmt* loadStmt = SVFUtil::dyn_cast<LoadStmt>(stmt))
+				vars.push_back(loadStmt->getRHSVarID());
+			else if (const CopyStmt* copy = SVFUtil::dyn_cast<CopyStmt>(stmt)) {
+				vars.push_back(copy->getRHSVarID());
+				for (const SVFStmt* copyStmt : copy->getRHSVar()->getInEdges()) {
+					if (const LoadStmt* loadStmt = SVFUtil::dyn_cast<LoadStmt>(copyStmt))
+						vars.push_back(loadStmt->getRHSVarID());
+				}
+			}
+		}
+	};
+	const SVFVar* cond = edge->getCondition();
+	collectWithPointers(cond);
+	for (const SVFStmt* stmt : cond->getInEdges()) {
+		if (const CmpStmt* cmp = SVFUtil::dyn_cast<CmpStmt>(stmt)) {
+			collectWithPointers(cmp->getOpVar(0));
+			collectWithPointers(cmp->getOpVar(1));
+		}
 	}
-	// Handle call procedure entries
-	else if (const CallPE* callPE = SVFUtil::dyn_cast<CallPE>(stmt)) {
-		updateStateOnCall(callPE);
+}
+
+/**
+ * @brief Load top-level variables from the def table into a state (sparse mode)
+ *
+ * A variable already in the state is kept: its value was refined by a branch on the edge into the node.
+ */
+void AbstractExecution::loadTopLevelVars(AbstractState& as, const std::vector<NodeID>& vars) const {
+	for (NodeID id : vars) {
+		if (as.inVarToValTable(id) || as.inVarToAddrsTable(id))
+			continue;
+		auto it = topLevelDefs.find(id);
+		if (it != topLevelDefs.end())
+			as[id] = it->second;
 	}
-	// Handle return procedure entries
-	else if (const RetPE* retPE = SVFUtil::dyn_cast<RetPE>(stmt)) {
-		updateStateOnRet(retPE);
+}
+
+/**
+ * @brief Move the top-level variables defined at a node from its state to the def table (sparse mode)
+ *
+ * Top-level variables are in SSA form, so each has one entry in the def table, written where it is defined
+ * and read where it is used, instead of being copied along every ICFG edge. A definition visited again (in a
+ * cycle or from another call site) is joined into its entry, and widened into it at the head of a cycle after
+ * Options::WidenDelay() visits, so that the def table converges. The nodes reading a changed entry are handled
+ * again, as the ICFG states they depend on may not have changed. The node's state keeps only the address-taken
+ * objects, which are still propagated densely along the ICFG.
+ *
+ * The def table is not keyed by calling context: a function analysed from several call sites holds the join of
+ * its values over all of them, and the return sites read that join, whereas the dense analysis has the values of
+ * each call site (see Tests/ae/test6.c).
+ *
+ * @param all Store all top-level variables of the state rather than only the ones the node defines (global node)
+ * @return Whether the def table has changed
+ */
+bool AbstractExecution::storeTopLevelVars(const ICFGNode* node, bool all) {
+	AbstractState& as = postAbsTrace[node];
+	Set<NodeID> defs;
+	if (!all) {
+		for (const LoweredStmt& stmt : loweredICFG.getStmts(node->getId())) {
+			if (stmt.kind == SVFStmt::Store || stmt.kind == SVFStmt::Branch)
+				continue;
+			defs.insert(stmt.res);
+			// An AddrStmt also initializes its object
+			if (stmt.kind == SVFStmt::Addr)
+				defs.insert(loweredICFG.getOperand(stmt, 0));
+		}
+		// The return value of an external call is set at its call site
+		if (const CallICFGNode* callNode = SVFUtil::dyn_cast<CallICFGNode>(node)) {
+			if (const SVFVar* ret = callNode->getRetICFGNode()->getActualRet())
+				defs.insert(ret->getId());
+		}
 	}
-	// Handle select statements
-	else if (const SelectStmt* select = SVFUtil::dyn_cast<SelectStmt>(stmt)) {
-		updateStateOnSelect(select);
+
+	// The definitions of a recursive function are widened across the passes of its fixpoint iteration as well
+	auto passes = recursionPasses.find(node->getFun());
+	bool widen = (cycleHeadToCycle.count(node) && ++sparseHeadVisits[node] > Options::WidenDelay())
+	             || (passes != recursionPasses.end() && passes->second > Options::WidenDelay());
+	bool changed = false;
+	for (const auto& item : as.getVarToVal()) {
+		if (!all && defs.find(item.first) == defs.end())
+			continue;
+		auto it = topLevelDefs.find(item.first);
+		if (it == topLevelDefs.end())
+			topLevelDefs.emplace(item.first, item.second);
+		else {
+			AbstractValue val = it->second;
+			if (widen)
+				val.widen_with(item.second);
+			else
+				val.join_with(item.second);
+			if (val.equals(it->second))
+				continue;
+			it->second = val;
+		}
+		changed = true;
+		auto users = topLevelUsers.find(item.first);
+		if (users == topLevelUsers.end())
+			continue;
+		for (const ICFGNode* user : users->second) {
+			// A user not handled yet reads the new value when it is reached
+			if (user != node && postAbsTrace.count(user))
+				pendingUses[user->getFun()].push_back(user);
+		}
 	}
-	// Handle unary operations and branch statements (no action needed)
-	else if (SVFUtil::isa<UnaryOPStmt>(stmt) || SVFUtil::isa<BranchStmt>(stmt)) {
-		// Nothing needs to be done here as BranchStmt is handled in hasBranchES
+
+	// Keep only the address-taken objects in the state
+	AbstractState objs;
+	for (const auto& item : as.getLocToVal())
+		objs.store(AbstractState::getVirtualMemAddress(item.first), item.second);
+	as = std::move(objs);
+	if (changed)
+		topLevelDefChangeNum++;
+	return changed;
+}
+
+namespace {
+	/// Stands in for AbstractExecution in benchStmtDispatch, so that only the cost of dispatching is measured
+	struct StmtCounter {
+		u64_t counts[SVFStmt::ThreadJoin + 1] = {};
+
+		template <typename STMT>
+		void count(const STMT* stmt) {
+			counts[stmt->getEdgeKind()]++;
+		}
+	};
+
+	/// The dyn_cast chain updateAbsState used before the table, in the same order
+	void dispatchByCast(StmtCounter& counter, const SVFStmt* stmt) {
+		if (const AddrStmt* addr = SVFUtil::dyn_cast<AddrStmt>(stmt))
+			counter.count(addr);
+		else if (const BinaryOPStmt* binary = SVFUtil::dyn_cast<BinaryOPStmt>(stmt))
+			counter.count(binary);
+		else if (const CmpStmt* cmp = SVFUtil::dyn_cast<CmpStmt>(stmt))
+			counter.count(cmp);
+		else if (const LoadStmt* load = SVFUtil::dyn_cast<LoadStmt>(stmt))
+			counter.count(load);
+		else if (const StoreStmt* store = SVFUtil::dyn_cast<StoreStmt>(stmt))
+			counter.count(store);
+		else if (const CopyStmt* copy = SVFUtil::dyn_cast<CopyStmt>(stmt))
+			counter.count(copy);
+		else if (const GepStmt* gep = SVFUtil::dyn_cast<GepStmt>(stmt))
+			counter.count(gep);
+		else if (const PhiStmt* phi = SVFUtil::dyn_cast<PhiStmt>(stmt))
+			counter.count(phi);
+		else if (const CallPE* callPE = SVFUtil::dyn_cast<CallPE>(stmt))
+			counter.count(callPE);
+		else if (const RetPE* retPE = SVFUtil::dyn_cast<RetPE>(stmt))
+			counter.count(retPE);
+		else if (const SelectStmt* select = SVFUtil::dyn_cast<SelectStmt>(stmt))
+			counter.count(select);
 	}
-	// Assert false for unsupported statement types
-	else {
-		assert(false && "implement this part");
+} // namespace
+
+/**
+ * @brief Microbenchmark of statement dispatch
+ *
+ * Dispatches the statements of all ICFG nodes round-robin until `millions` million statements are dispatched,
+ * once through the dyn_cast chain and once through a kind-indexed table, and prints the time of both.
+ */
+void AbstractExecution::benchStmtDispatch(u32_t millions) {
+	std::vector<const SVFStmt*> stmts;
+	for (auto it = icfg->begin(); it != icfg->end(); ++it) {
+		for (const SVFStmt* stmt : it->second->getSVFStmts())
+			stmts.push_back(stmt);
 	}
-}
+	if (stmts.empty())
+		return;
+
+	StmtDispatcher<StmtCounter> table;
+	table.set<SVFStmt::Addr, AddrStmt, &StmtCounter::count<AddrStmt>>();
+	table.set<SVFStmt::BinaryOp, BinaryOPStmt, &StmtCounter::count<BinaryOPStmt>>();
+	table.set<SVFStmt::Cmp, CmpStmt, &StmtCounter::count<CmpStmt>>();
+	table.set<SVFStmt::Load, LoadStmt, &StmtCounter::count<LoadStmt>>();
+	table.set<SVFStmt::Store, StoreStmt, &StmtCounter::count<StoreStmt>>();
+	table.set<SVFStmt::Copy, CopyStmt, &StmtCounter::count<CopyStmt>>();
+	table.set<SVFStmt::Gep, GepStmt, &StmtCounter::count<GepStmt>>();
+	table.set<SVFStmt::Phi, PhiStmt, &StmtCounter::count<PhiStmt>>();
+	table.set<SVFStmt::Call, CallPE, &StmtCounter::count<CallPE>>();
+	table.set<SVFStmt::ThreadFork, CallPE, &StmtCounter::count<CallPE>>();
+	table.set<SVFStmt::Ret, RetPE, &StmtCounter::count<RetPE>>();
+	table.set<SVFStmt::ThreadJoin, RetPE, &StmtCounter::count<RetPE>>();
+	table.set<SVFStmt::Select, SelectStmt, &StmtCounter::count<SelectStmt>>();
+	table.ignore(SVFStmt::UnaryOp);
+	table.ignore(SVFStmt::Branch);
+
+	const u64_t total = (u64_t)millions * 1000000;
+	auto run = [&](StmtCounter& counter, auto dispatch) {
+		auto start = std::chrono::steady_clock::now();
+		for (u64_t i = 0, j = 0; i < total; ++i, j = (j + 1 == stmts.size() ? 0 : j + 1))
+			dispatch(counter, stmts[j]);
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	};
+	StmtCounter castCounter, tableCounter;
+	double castTime = run(castCounter, dispatchByCast);
+	double tableTime = run(tableCounter, [&](StmtCounter& counter, const SVFStmt* stmt) {
+		table.dispatch(counter, stmt);
+	});
+	assert(std::equal(std::begin(castCounter.counts), std::end(castCounter.counts), std::begin(tableCounter.counts)) &&
+	       "dyn_cast chain and table dispatched differently?");
+	// Print the numbers of handled statements so that the dispatch loops are not optimized away
+	auto handled = [](const StmtCounter& counter) {
+		return std::accumulate(std::begin(counter.counts), std::end(counter.counts), (u64_t)0);
+	};
 
+	std::cout << "Dispatch of " << millions << "M statements (" << stmts.size() << " distinct):\n"
+	          << "  dyn_cast chain: " << castTime << " ms (" << castTime / millions << " ms per million, "
+	          << handled(castCounter) << " handled)\n"
+	          << "  kind table:     " << tableTime << " ms (" << tableTime / millions << " ms per million, "
+	          << handled(tableCounter) << " handled)\n";
+}
 
 /**
  * @brief Handle a call site in the control flow graph
@@ -676,7 +1189,9 @@ void AbstractExecution::handleCallSite(const CallICFGNode* callNode) {
 	const FunObjVar* callee = callNode->getCalledFunction();
 	std::string fun_name = callee->getName();
 	if (fun_name == "OVERFLOW" || fun_name == "svf_assert" || fun_name == "svf_assert_eq") {
-		handleStubFunctions(callNode);
+		// The states of a recursion are not sound before its summaries converge (handleRecursiveCall)
+		if (!deferStubChecks)
+			handleStubFunctions(callNode);
 	} 
 	else if (fun_name == "nd" || fun_name == "rand") {
 		NodeID lhsId = callNode->getRetICFGNode()->getActualRet()->getId();
@@ -691,8 +1206,15 @@ void AbstractExecution::handleCallSite(const CallICFGNode* callNode) {
 		utils->handleExtAPI(callNode);
 	}
 	else if (recursiveFuns.find(callee) != recursiveFuns.end()) {
-		// skip recursive functions
-		return;
+		handleRecursiveCall(callNode, callee);
+	}
+	else if (AEOptions::Summaries()) {
+		// Reuse a summary of the callee if one covers the state at the call site, otherwise analyse and summarize it
+		AbstractState input = postAbsTrace[callNode];
+		if (!applySummary(callNode, callee, input)) {
+			handleFunction(svfir->getICFG()->getFunEntryICFGNode(callee));
+			recordSummary(callNode, callee, input);
+		}
 	}
 	else {
 		// Handle the callee function
@@ -700,91 +1222,431 @@ void AbstractExecution::handleCallSite(const CallICFGNode* callNode) {
 	}
 }
 
+/// Collect the ICFGNodes of a WTO component
+static void collectWTOComp(const ICFGWTOComp* comp, std::vector<const ICFGNode*>& nodes) {
+	if (const ICFGSingletonWTO* singleton = SVFUtil::dyn_cast<ICFGSingletonWTO>(comp))
+		nodes.push_back(singleton->getICFGNode());
+	else if (const ICFGCycleWTO* cycle = SVFUtil::dyn_cast<ICFGCycleWTO>(comp)) {
+		nodes.push_back(cycle->head()->getICFGNode());
+		for (const ICFGWTOComp* inner : cycle->getWTOComponents())
+			collectWTOComp(inner, nodes);
+	}
+}
+
+/**
+ * @brief Handle a call to a function in a recursion (a cycle of the call graph)
+ *
+ * The first call into the recursion iterates the callee to a fixpoint of its input and output summary. Each pass
+ * analyses the callee afresh, its trace cleared so that no state of the previous pass (e.g., an exit no longer
+ * reached) survives. Recursive calls inside it (to the callee or other functions of its SCC already being
+ * iterated) do not descend: their return sites read the callee's current output summary, starting from no output
+ * (bottom), in mergeStatesFromPredecessors. After a pass, the states at all call sites of the callee, including
+ * the recursive ones handled in the pass, are joined into its input, and its exit state into its output. Both are
+ * widened after Options::WidenDelay() passes, and the passes stop once neither changes. The output is published as
+ * the state of the callee's exit only then, for the return site of this call.
+ *
+ * The stub calls (svf_assert, OVERFLOW) are not checked in these passes, as their states are not yet sound. Once
+ * the summaries converge, the outermost recursion analyses the callee once more from them and checks the stubs.
+ * The exit state of that pass is published instead of the output summary, which it refines (e.g., below a bound
+ * the widened summary lost). In sparse mode the passes also go on while the def table changes.
+ */
+void AbstractExecution::handleRecursiveCall(const CallICFGNode* callNode, const FunObjVar* callee) {
+	// A call back into a function being iterated: its return site reads the current summary
+	if (recursionPasses.find(callee) != recursionPasses.end())
+		return;
+
+	const ICFGNode* entry = icfg->getFunEntryICFGNode(callee);
+	const ICFGNode* exit = icfg->getFunExitICFGNode(callee);
+	std::vector<const ICFGNode*> nodes;
+	for (const ICFGWTOComp* comp : getWTO(callee)->getWTOComponents())
+		collectWTOComp(comp, nodes);
+	u32_t& passes = recursionPasses[callee];
+	bool checkStubs = !deferStubChecks;
+	deferStubChecks = true;
+	while (true) {
+		passes++;
+		for (const ICFGNode* node : nodes) {
+			postAbsTrace.erase(node);
+			preAbsTrace.erase(node);
+		}
+		u32_t defChanges = topLevelDefChangeNum;
+		handleFunction(entry);
+		// In sparse mode the values returned are top-level variables, which live in the def table
+		bool defChanged = topLevelDefChangeNum != defChanges;
+
+		// The input may grow from the recursive call sites handled in this pass
+		AbstractState in;
+		bool inChanged = mergeStatesFromPredecessors(entry, in) && widenRecursiveEntry(callee, in);
+		bool outChanged = false;
+		auto exitIt = postAbsTrace.find(exit);
+		if (exitIt != postAbsTrace.end()) {
+			auto out = recursionOut.find(callee);
+			if (out == recursionOut.end()) {
+				recursionOut.emplace(callee, exitIt->second);
+				outChanged = true;
+			}
+			else {
+				AbstractState newOut = out->second;
+				newOut.joinWith(exitIt->second);
+				if (passes > Options::WidenDelay())
+					newOut = out->second.widening(newOut);
+				outChanged = newOut != out->second;
+				out->second = std::move(newOut);
+			}
+		}
+		if (!outChanged && !inChanged && !defChanged)
+			break;
+	}
+	deferStubChecks = !checkStubs;
+	if (checkStubs) {
+		// The states of this pass are computed from the converged summaries, so the stub calls are checked on them
+		passes++;
+		for (const ICFGNode* node : nodes) {
+			postAbsTrace.erase(node);
+			preAbsTrace.erase(node);
+		}
+		handleFunction(entry);
+	}
+
+	// The pass from the converged summaries refines the output soundly (as a narrowing step), so the exit state it
+	// reached is kept
+	bool refined = checkStubs && postAbsTrace.find(exit) != postAbsTrace.end();
+	if (!refined) {
+		auto out = recursionOut.find(callee);
+		if (out != recursionOut.end())
+			postAbsTrace[exit] = out->second;
+		else
+			postAbsTrace.erase(exit);
+	}
+	recursionSCCPasses[recursionSCC[callee]] += passes;
+	recursionPasses.erase(callee);
+	recursionEntryIn.erase(callee);
+	// Summaries of inner recursive functions are kept across the passes of the outermost one, which they depend on
+	if (recursionPasses.empty())
+		recursionOut.clear();
+}
+
+/**
+ * @brief Widen the input of a function under recursion fixpoint iteration with its input so far
+ *
+ * @return Whether the input has changed
+ */
+bool AbstractExecution::widenRecursiveEntry(const FunObjVar* fun, AbstractState& as) {
+	auto passes = recursionPasses.find(fun);
+	if (passes == recursionPasses.end())
+		return false;
+	auto in = recursionEntryIn.find(fun);
+	if (in == recursionEntryIn.end()) {
+		recursionEntryIn[fun] = as;
+		return true;
+	}
+	AbstractState newIn = in->second;
+	newIn.joinWith(as);
+	if (passes->second > Options::WidenDelay())
+		newIn = in->second.widening(newIn);
+	bool changed = newIn != in->second;
+	if (changed)
+		in->second = newIn;
+	as = std::move(newIn);
+	return changed;
+}
+
+/**
+ * @brief Reuse a summary of the callee for a call site
+ *
+ * A summary applies if its input is the state at the call site or, unless
+ * -ae-summary-exact is set, subsumes it, in which case its output over-approximates the callee's output.
+ * Its output is restored as the state of the callee's exit, from which the return site merges.
+ *
+ * @return Whether a summary was applied
+ */
+bool AbstractExecution::applySummary(const CallICFGNode* callNode, const FunObjVar* callee,
+                                     const AbstractState& input) {
+	auto it = funSummaries.find(callee);
+	if (it != funSummaries.end()) {
+		for (const FunSummary& summary : it->second) {
+			bool exact = summary.input == input;
+			if (!exact) {
+				if (AEOptions::SummaryExact())
+					continue;
+				// input <= summary.input iff joining input into summary.input leaves it unchanged
+				AbstractState joined = summary.input;
+				joined.joinWith(input);
+				if (joined != summary.input)
+					continue;
+			}
+			postAbsTrace[icfg->getFunExitICFGNode(callee)] = summary.output;
+			for (const auto& def : summary.retDefs) {
+				auto it = topLevelDefs.find(def.first);
+				if (it == topLevelDefs.end())
+					topLevelDefs.insert(def);
+				else
+					it->second.join_with(def.second);
+			}
+			if (exact)
+				summaryExactHitNum++;
+			else
+				summarySubsumedHitNum++;
+			return true;
+		}
+	}
+	summaryMissNum++;
+	return false;
+}
+
+/// Summarize the callee just analysed from a call site, keeping at most -ae-summaries summaries per function
+void AbstractExecution::recordSummary(const CallICFGNode* callNode, const FunObjVar* callee,
+                                      const AbstractState& input) {
+	auto exitIt = postAbsTrace.find(icfg->getFunExitICFGNode(callee));
+	// The exit is not reachable from this input
+	if (exitIt == postAbsTrace.end())
+		return;
+	FunSummary summary{input, exitIt->second, {}};
+	// In sparse mode, the return values are top-level variables read at the return site
+	if (AEOptions::Sparse()) {
+		for (const LoweredStmt& stmt : loweredICFG.getStmts(callNode->getRetICFGNode()->getId())) {
+			for (u32_t i = 0; i < stmt.opNum; ++i) {
+				auto def = topLevelDefs.find(loweredICFG.getOperand(stmt, i));
+				if (def != topLevelDefs.end())
+					summary.retDefs.insert(*def);
+			}
+		}
+	}
+	std::deque<FunSummary>& summaries = funSummaries[callee];
+	summaries.push_back(std::move(summary));
+	if (summaries.size() > AEOptions::Summaries()) {
+		summaries.pop_front();
+		summaryEvictNum++;
+	}
+}
+
 /**
  * @brief Get the next nodes of a node
  * 
  * Returns the next nodes of a node that are inside the same function.
  * And if CallICFGNode, shortcut to the RetICFGNode	.
+ * They are computed once by initNextNodes.
  * 
  * @param node The node to get the next nodes of
  * @return The next nodes of the node
  */
-std::vector<const ICFGNode*> AbstractExecution::getNextNodes(const ICFGNode* node) const {
-	std::vector<const ICFGNode*> outEdges;
-	for (const ICFGEdge* edge : node->getOutEdges()) {
-		const ICFGNode* dst = edge->getDstNode();
-		// Only nodes inside the same function are included
-		if (dst->getFun() == node->getFun()) {
-			outEdges.push_back(dst);
-		}
-	}
-	if (const CallICFGNode* callNode = SVFUtil::dyn_cast<CallICFGNode>(node)) {
-		// Shortcut to the RetICFGNode
-		const ICFGNode* retNode = callNode->getRetICFGNode();
-		outEdges.push_back(retNode);
-	}
-	return outEdges;
+const std::vector<const ICFGNode*>& AbstractExecution::getNextNodes(const ICFGNode* node) const {
+	assert(node->getId() < nextNodes.size() && "next nodes not initialized?");
+	return nextNodes[node->getId()];
 }
 
 /**
  * @brief Get the next nodes of a cycle
- * 
- * Returns the next nodes of cycle components that are outside the cycle.
- * Inner cycles are skipped since their next nodes cannot be outside the outer cycle.
- * And Inner cycles are handled in the outer cycle.
- * Only nodes that point outside the cycle are included in cycleNext.
- * 
+ *
+ * Returns the next nodes of the cycle's head and of the nodes in its body (excluding inner cycles,
+ * whose next nodes stay inside the outer cycle) that are outside the cycle.
+ * They are computed once by initNextNodes.
+ *
  * @param cycle The cycle to get the next nodes of
  * @return The next nodes of the cycle
  */
-std::vector<const ICFGNode*> AbstractExecution::getNextNodesOfCycle(const ICFGCycleWTO* cycle) const {
-	Set<const ICFGNode*> cycleNodes;
-	// Insert the head of the cycle and the heads of the inner cycles
-	cycleNodes.insert(cycle->head()->getICFGNode());
-	for (const ICFGWTOComp* comp : cycle->getWTOComponents()) {
-		if (const ICFGSingletonWTO* singleton = SVFUtil::dyn_cast<ICFGSingletonWTO>(comp)) {
-			cycleNodes.insert(singleton->getICFGNode());
-		} else if (const ICFGCycleWTO* subCycle = SVFUtil::dyn_cast<ICFGCycleWTO>(comp)) {
-			cycleNodes.insert(subCycle->head()->getICFGNode());
+const std::vector<const ICFGNode*>& AbstractExecution::getNextNodesOfCycle(const ICFGCycleWTO* cycle) const {
+	auto it = cycleExits.find(cycle);
+	assert(it != cycleExits.end() && "cycle not in any WTO?");
+	return it->second;
+}
+
+/**
+ * @brief Compute the next nodes of every ICFGNode and of every WTO cycle
+ *
+ * Called by initWTO so that the fixpoint driver navigates the ICFG without allocating.
+ */
+void AbstractExecution::initNextNodes() {
+	nextNodes.resize(icfg->getTotalNodeNum());
+	for (auto it = icfg->begin(); it != icfg->end(); ++it) {
+		const ICFGNode* node = it->second;
+		if (node->getId() >= nextNodes.size())
+			nextNodes.resize(node->getId() + 1);
+		std::vector<const ICFGNode*>& next = nextNodes[node->getId()];
+		for (const ICFGEdge* edge : node->getOutEdges()) {
+			const ICFGNode* dst = edge->getDstNode();
+			// Only nodes inside the same function are included
+			if (dst->getFun() == node->getFun()) {
+				next.push_back(dst);
+			}
 		}
-	}
-	std::vector<const ICFGNode*> outEdges;
-	std::vector<const ICFGNode*> nextNodes = getNextNodes(cycle->head()->getICFGNode());
-	for (const ICFGNode* nextNode : nextNodes) {
-		// Only nodes that point outside the cycle are included
-		if (cycleNodes.find(nextNode) == cycleNodes.end()) {
-			outEdges.push_back(nextNode);
+		if (const CallICFGNode* callNode = SVFUtil::dyn_cast<CallICFGNode>(node)) {
+			// Shortcut to the RetICFGNode
+			next.push_back(callNode->getRetICFGNode());
 		}
 	}
+}
+
+/// Compute the next nodes and widening thresholds of a cycle and its inner cycles, returning the IDs of the cycle's nodes
+NodeBS AbstractExecution::initCycleInfo(const ICFGCycleWTO* cycle) {
+	// The nodes of the cycle, including those of the inner cycles
+	NodeBS cycleNodes;
+	cycleNodes.set(cycle->head()->getICFGNode()->getId());
 	for (const ICFGWTOComp* comp : cycle->getWTOComponents()) {
-		if (const ICFGSingletonWTO* singleton = SVFUtil::dyn_cast<ICFGSingletonWTO>(comp)) {
-			std::vector<const ICFGNode*> nextNodes = getNextNodes(singleton->getICFGNode());
+		if (const ICFGSingletonWTO* singleton = SVFUtil::dyn_cast<ICFGSingletonWTO>(comp))
+			cycleNodes.set(singleton->getICFGNode()->getId());
+		else if (const ICFGCycleWTO* subCycle = SVFUtil::dyn_cast<ICFGCycleWTO>(comp))
+			cycleNodes |= initCycleInfo(subCycle);
+	}
+
+	std::vector<const ICFGNode*>& exits = cycleExits[cycle];
+	auto addExits = [&](const ICFGNode* node) {
+		for (const ICFGNode* nextNode : getNextNodes(node)) {
 			// Only nodes that point outside the cycle are included
-			for (const ICFGNode* nextNode : nextNodes) {
-				if (cycleNodes.find(nextNode) == cycleNodes.end()) {
-					outEdges.push_back(nextNode);
+			if (!cycleNodes.test(nextNode->getId()))
+				exits.push_back(nextNode);
+		}
+	};
+	addExits(cycle->head()->getICFGNode());
+	for (const ICFGWTOComp* comp : cycle->getWTOComponents()) {
+		// skip inner cycle inside the outer cycle, because 1) it will be handled in the outer cycle.
+		// 2) its next nodes won't be outside the outer cycle.
+		if (const ICFGSingletonWTO* singleton = SVFUtil::dyn_cast<ICFGSingletonWTO>(comp))
+			addExits(singleton->getICFGNode());
+	}
+
+	// Thresholds are the constants compared in the cycle and their neighbours, e.g., i < 10 gives {9, 10, 11}
+	std::set<s64_t>& thresholds = cycleThresholds[cycle];
+	for (NodeID id : cycleNodes) {
+		for (const SVFStmt* stmt : icfg->getICFGNode(id)->getSVFStmts()) {
+			if (const CmpStmt* cmp = SVFUtil::dyn_cast<CmpStmt>(stmt)) {
+				for (u32_t i = 0; i < 2; ++i) {
+					if (const ConstIntValVar* c = SVFUtil::dyn_cast<ConstIntValVar>(cmp->getOpVar(i))) {
+						thresholds.insert(c->getSExtValue() - 1);
+						thresholds.insert(c->getSExtValue());
+						thresholds.insert(c->getSExtValue() + 1);
+					}
 				}
 			}
-		} else if (const ICFGCycleWTO* subCycle = SVFUtil::dyn_cast<ICFGCycleWTO>(comp)) {
-			// skip inner cycle inside the outer cycle, because 1) it will be handled in the outer cycle. 
-			//2) its next nodes won't be outside the outer cycle.
-			continue;
 		}
 	}
-	return outEdges;
+	cycleHeadVisits[cycle->head()->getICFGNode()] = 0;
+	return cycleNodes;
+}
+
+/**
+ * @brief Widen the state of a cycle's head
+ *
+ * With -ae-widen-thresholds, a bound that widening would push to infinity stops at the nearest threshold of
+ * the cycle beyond the bound in `cur` instead, e.g., [0, 5] widened with [0, 6] in a cycle of i < 10 is [0, 9].
+ * Later iterations widen past a threshold once it is exceeded, so the iteration still terminates.
+ *
+ * @param prev The state of the previous iteration
+ * @param cur The state of the current iteration
+ * @param cycle The cycle whose head the states belong to
+ * @return The widened state
+ */
+AbstractState AbstractExecution::widenState(AbstractState& prev, const AbstractState& cur, const ICFGCycleWTO* cycle) {
+	AbstractState widened = prev.widening(cur);
+	auto it = cycleThresholds.find(cycle);
+	if (!AEOptions::WidenThresholds() || it == cycleThresholds.end() || it->second.empty())
+		return widened;
+	const std::set<s64_t>& thresholds = it->second;
+
+	auto applyThresholds = [&](AbstractValue& w, const AbstractValue& c) {
+		if (!w.isInterval() || !c.isInterval() || w.getInterval().isBottom() || c.getInterval().isBottom())
+			return;
+		IntervalValue& wi = w.getInterval();
+		const IntervalValue& ci = c.getInterval();
+		if (wi.ub().is_plus_infinity() && !ci.ub().is_infinity()) {
+			auto t = thresholds.lower_bound(ci.ub().getIntNumeral());
+			if (t != thresholds.end())
+				wi.setUb(BoundedInt(*t));
+		}
+		if (wi.lb().is_minus_infinity() && !ci.lb().is_infinity()) {
+			auto t = thresholds.upper_bound(ci.lb().getIntNumeral());
+			if (t != thresholds.begin())
+				wi.setLb(BoundedInt(*std::prev(t)));
+		}
+	};
+	std::vector<u32_t> ids;
+	for (const auto& item : widened.getVarToVal())
+		ids.push_back(item.first);
+	for (u32_t id : ids) {
+		auto c = cur.getVarToVal().find(id);
+		if (c != cur.getVarToVal().end())
+			applyThresholds(widened[id], c->second);
+	}
+	ids.clear();
+	for (const auto& item : widened.getLocToVal())
+		ids.push_back(item.first);
+	for (u32_t id : ids) {
+		auto c = cur.getLocToVal().find(id);
+		if (c != cur.getLocToVal().end())
+			applyThresholds(widened.load(AbstractState::getVirtualMemAddress(id)), c->second);
+	}
+	return widened;
+}
+
+/**
+ * @brief Widen or narrow the state of a cycle's head after an iteration has handled the head
+ *
+ * While the iteration is increasing, the head's state is widened with widenState after Options::WidenDelay()
+ * iterations, and the narrowing phase starts once widening no longer changes it. Narrowing then refines the state
+ * until it is stable or AEOptions::NarrowIterations() narrowings were applied (if it is not 0).
+ *
+ * @param cycle The cycle whose head is widened or narrowed
+ * @param prev The state of the head before the iteration
+ * @param iteration The number of the iteration, starting from 0
+ * @param increasing Whether the cycle is in the widening phase, cleared when the narrowing phase starts
+ * @param narrowings The number of narrowings applied so far
+ * @return true if the cycle reached its fixpoint and the iteration can stop
+ */
+bool AbstractExecution::widenNarrowHead(const ICFGCycleWTO* cycle, AbstractState& prev, u32_t iteration,
+                                        bool& increasing, u32_t& narrowings) {
+	auto it = postAbsTrace.find(cycle->head()->getICFGNode());
+	// the head is unreachable, so is the rest of the cycle
+	if (it == postAbsTrace.end())
+		return true;
+	AbstractState& cur = it->second;
+	if (increasing) {
+		if (iteration < Options::WidenDelay())
+			return false;
+		cur = widenState(prev, cur, cycle);
+		if (cur == prev)
+			increasing = false;
+		return false;
+	}
+	cur = prev.narrowing(cur);
+	++narrowings;
+	return cur == prev || (AEOptions::NarrowIterations() > 0 && narrowings >= AEOptions::NarrowIterations());
 }
 
 void AbstractExecution::handleFunction(const ICFGNode* funEntry)
  {
-	FIFOWorkList<const ICFGNode*> worklist;
+	getWTO(funEntry->getFun());
+	if (AEOptions::WTOWorkList()) {
+		WTOWorkList worklist(wtoIndex);
+		handleFunction(funEntry, worklist);
+	}
+	else {
+		FIFOWorkList<const ICFGNode*> worklist;
+		handleFunction(funEntry, worklist);
+	}
+}
+
+/// Handle the nodes of a function from its entry in the order of `worklist`
+template <typename WorkList>
+void AbstractExecution::handleFunction(const ICFGNode* funEntry, WorkList& worklist)
+ {
+	const FunObjVar* fun = funEntry->getFun();
 	worklist.push(funEntry);
-	while (!worklist.empty()) {
+	while (true) {
+		// The users of definitions changed since they were handled are handled again (sparse mode)
+		auto pending = pendingUses.find(fun);
+		if (pending != pendingUses.end()) {
+			for (const ICFGNode* user : pending->second)
+				worklist.push(user);
+			pendingUses.erase(pending);
+		}
+		if (worklist.empty())
+			break;
 		const ICFGNode* node = worklist.pop();
-		if (cycleHeadToCycle.find(node) != cycleHeadToCycle.end()) {
-			const ICFGCycleWTO* cycle = cycleHeadToCycle[node];
+		auto cycleIt = cycleHeadToCycle.find(node);
+		if (cycleIt != cycleHeadToCycle.end()) {
+			const ICFGCycleWTO* cycle = cycleIt->second;
 			handleICFGCycle(cycle);
-			std::vector<const ICFGNode*> cycleNextNodes = getNextNodesOfCycle(cycle);
-			for (const ICFGNode* nextNode : cycleNextNodes) {
+			for (const ICFGNode* nextNode : getNextNodesOfCycle(cycle)) {
 				worklist.push(nextNode);
 			}
 		}
@@ -793,8 +1655,7 @@ void AbstractExecution::handleFunction(const ICFGNode* funEntry)
 				SVFUtil::errs() << "Fixpoint reached or infeasible for node " << node->getId() << "\n";
 				continue;
 			}
-			std::vector<const ICFGNode*> nextNodes = getNextNodes(node);
-			for (const ICFGNode* nextNode : nextNodes) {
+			for (const ICFGNode* nextNode : getNextNodes(node)) {
 				worklist.push(nextNode);
 			}
 		}
@@ -29,7 +29,116 @@
 #include "AE/Svfexe/AEDetector.h"
 #include "AE/Core/ICFGWTO.h"
 #include "Util/SVFBugReport.h"
+#include <climits>
+#include <set>
+#include <tuple>
 namespace SVF {
+	class AbstractExecution;
+
+	/// An SVFStmt lowered once before the analysis: the handler of its kind is resolved and its result and operands are
+	/// decoded, so that revisiting its ICFGNode (e.g., in every iteration of a cycle) re-derives none of them
+	struct LoweredStmt {
+		typedef void (*Handler)(AbstractExecution&, const SVFStmt*);
+
+		Handler handler;
+		const SVFStmt* stmt;
+		SVFStmt::PEDGEK kind;
+		/// Result (LHS) variable
+		NodeID res;
+		/// Operand (RHS) variables, [opBegin, opBegin + opNum) of LoweredICFG's operands
+		u32_t opBegin;
+		u32_t opNum;
+	};
+
+	/// The lowered statements of all ICFGNodes, stored contiguously node by node
+	class LoweredICFG {
+	 public:
+		/// The lowered statements of a node in their order in ICFGNode::getSVFStmts()
+		class StmtRange {
+		 public:
+			StmtRange(const LoweredStmt* first, const LoweredStmt* last) : first(first), last(last) {}
+			const LoweredStmt* begin() const {
+				return first;
+			}
+			const LoweredStmt* end() const {
+				return last;
+			}
+
+		 private:
+			const LoweredStmt* first;
+			const LoweredStmt* last;
+		};
+
+		/// Start lowering the statements of node `id`
+		void beginNode(NodeID id) {
+			if (id >= nodeToStmts.size())
+				nodeToStmts.resize(id + 1, std::make_pair(0, 0));
+			nodeToStmts[id].first = nodeToStmts[id].second = stmts.size();
+			curNode = id;
+		}
+
+		/// Append a statement of the node being lowered, its operands are appended with addOperand
+		LoweredStmt& addStmt(const SVFStmt* stmt, LoweredStmt::Handler handler) {
+			stmts.push_back({handler, stmt, (SVFStmt::PEDGEK)stmt->getEdgeKind(), 0, (u32_t)operands.size(), 0});
+			nodeToStmts[curNode].second++;
+			return stmts.back();
+		}
+
+		void addOperand(NodeID id) {
+			operands.push_back(id);
+			stmts.back().opNum++;
+		}
+
+		StmtRange getStmts(NodeID id) const {
+			assert(id < nodeToStmts.size() && "ICFGNode not lowered?");
+			const LoweredStmt* base = stmts.data();
+			return StmtRange(base + nodeToStmts[id].first, base + nodeToStmts[id].second);
+		}
+
+		NodeID getOperand(const LoweredStmt& stmt, u32_t i) const {
+			assert(i < stmt.opNum && "operand out of range");
+			return operands[stmt.opBegin + i];
+		}
+
+	 private:
+		std::vector<LoweredStmt> stmts;
+		std::vector<NodeID> operands;
+		/// Indexed by ICFGNode ID, the range of its statements in stmts
+		std::vector<std::pair<u32_t, u32_t>> nodeToStmts;
+		/// The node being lowered
+		NodeID curNode = 0;
+	};
+
+	/// A worklist of ICFGNodes popped in weak topological order (the smallest WTO index first, then the smallest node
+	/// ID), holding each node once
+	class WTOWorkList {
+	 public:
+		/// `wtoIndex` maps an ICFGNode ID to its WTO index
+		explicit WTOWorkList(const std::vector<u32_t>& wtoIndex) : wtoIndex(wtoIndex) {}
+
+		bool empty() const {
+			return nodes.empty();
+		}
+
+		/// Return false if the node is already in the worklist
+		bool push(const ICFGNode* node) {
+			u32_t index = node->getId() < wtoIndex.size() ? wtoIndex[node->getId()] : UINT_MAX;
+			return nodes.emplace(index, node->getId(), node).second;
+		}
+
+		const ICFGNode* pop() {
+			auto first = nodes.begin();
+			const ICFGNode* node = std::get<2>(*first);
+			nodes.erase(first);
+			return node;
+		}
+
+	 private:
+		const std::vector<u32_t>& wtoIndex;
+		/// Nodes outside any WTO share the index UINT_MAX, so the node ID keeps their order deterministic
+		std::set<std::tuple<u32_t, NodeID, const ICFGNode*>> nodes;
+	};
+
 	class AbstractExecutionHelper {
 	 public:
 		/// Add a detected bug to the bug reporter and print the report
@@ -36,6 +36,7 @@ int main(int argc, char** argv) {
 	builder.updateCallGraph(callgraph);
 	pag->getICFG()->updateCallGraph(callgraph);
 	AbstractExecution* ae = new AbstractExecution();
+	ae->setPointerAnalysis(ander);
 	ae->runOnModule(pag->getICFG());
 	ae->ensureAllAssertsValidated();
 
@@ -0,0 +1,27 @@
+#include "stdbool.h"
+extern void svf_assert(bool);
+
+int g(int n);
+
+int f(int n)
+{
+    if (n <= 0)
+        return 0;
+    int r = g(n - 1) + 1;
+    if (r > 10)
+        r = 10;
+    return r;
+}
+
+int g(int n)
+{
+    return f(n);
+}
+
+int main() {
+  int r;
+  r = f(3);
+  svf_assert(r >= 0);
+  svf_assert(r <= 10);
+  return 0;
+}
@@ -0,0 +1,119 @@
+; ModuleID = './test5.ll'
+source_filename = "test5.c"
+target datalayout = "e-m:o-i64:64-i128:128-n32:64-S128"
+target triple = "arm64-apple-macosx14.0.0"
+
+; Function Attrs: noinline nounwind ssp uwtable(sync)
+define i32 @f(i32 noundef %n) #0 !dbg !9 {
+entry:
+  call void @llvm.dbg.value(metadata i32 %n, metadata !14, metadata !DIExpression()), !dbg !15
+  %cmp = icmp sle i32 %n, 0, !dbg !16
+  br i1 %cmp, label %if.then, label %if.end, !dbg !18
+
+if.then:                                          ; preds = %entry
+  br label %return, !dbg !19
+
+if.end:                                           ; preds = %entry
+  %sub = sub nsw i32 %n, 1, !dbg !20
+  %call = call i32 @g(i32 noundef %sub), !dbg !21
+  %add = add nsw i32 %call, 1, !dbg !22
+  call void @llvm.dbg.value(metadata i32 %add, metadata !23, metadata !DIExpression()), !dbg !15
+  %cmp1 = icmp sgt i32 %add, 10, !dbg !24
+  br i1 %cmp1, label %if.then2, label %if.end3, !dbg !26
+
+if.then2:                                         ; preds = %if.end
+  call void @llvm.dbg.value(metadata i32 10, metadata !23, metadata !DIExpression()), !dbg !15
+  br label %if.end3, !dbg !27
+
+if.end3:                                          ; preds = %if.then2, %if.end
+  %r.0 = phi i32 [ 10, %if.then2 ], [ %add, %if.end ], !dbg !15
+  call void @llvm.dbg.value(metadata i32 %r.0, metadata !23, metadata !DIExpression()), !dbg !15
+  br label %return, !dbg !28
+
+return:                                           ; preds = %if.end3, %if.then
+  %retval.0 = phi i32 [ 0, %if.then ], [ %r.0, %if.end3 ], !dbg !15
+  ret i32 %retval.0, !dbg !29
+}
+
+; Function Attrs: nocallback nofree nosync nounwind speculatable willreturn memory(none)
+declare void @llvm.dbg.declare(metadata, metadata, metadata) #1
+
+; Function Attrs: noinline nounwind ssp uwtable(sync)
+define i32 @g(i32 noundef %n) #0 !dbg !30 {
+entry:
+  call void @llvm.dbg.value(metadata i32 %n, metadata !31, metadata !DIExpression()), !dbg !32
+  %call = call i32 @f(i32 noundef %n), !dbg !33
+  ret i32 %call, !dbg !34
+}
+
+; Function Attrs: noinline nounwind ssp uwtable(sync)
+define i32 @main() #0 !dbg !35 {
+entry:
+  %call = call i32 @f(i32 noundef 3), !dbg !38
+  call void @llvm.dbg.value(metadata i32 %call, metadata !39, metadata !DIExpression()), !dbg !40
+  %cmp = icmp sge i32 %call, 0, !dbg !41
+  call void @svf_assert(i1 noundef zeroext %cmp), !dbg !42
+  %cmp1 = icmp sle i32 %call, 10, !dbg !43
+  call void @svf_assert(i1 noundef zeroext %cmp1), !dbg !44
+  ret i32 0, !dbg !45
+}
+
+declare void @svf_assert(i1 noundef zeroext) #2
+
+; Function Attrs: nocallback nofree nosync nounwind speculatable willreturn memory(none)
+declare void @llvm.dbg.value(metadata, metadata, metadata) #1
+
+attributes #0 = { noinline nounwind ssp uwtable(sync) "frame-pointer"="non-leaf" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="apple-m1" "target-features"="+aes,+crc,+crypto,+dotprod,+fp-armv8,+fp16fml,+fullfp16,+lse,+neon,+ras,+rcpc,+rdm,+sha2,+sha3,+sm4,+v8.1a,+v8.2a,+v8.3a,+v8.4a,+v8.5a,+v8a,+zcm,+zcz" }
+attributes #1 = { nocallback nofree nosync nounwind speculatable willreturn memory(none) }
+attributes #2 = { "frame-pointer"="non-leaf" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="apple-m1" "target-features"="+aes,+crc,+crypto,+dotprod,+fp-armv8,+fp16fml,+fullfp16,+lse,+neon,+ras,+rcpc,+rdm,+sha2,+sha3,+sm4,+v8.1a,+v8.2a,+v8.3a,+v8.4a,+v8.5a,+v8a,+zcm,+zcz" }
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!2, !3, !4, !5, !6, !7}
+!llvm.ident = !{!8}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C11, file: !1, producer: "Homebrew clang version 16.0.6", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, splitDebugInlining: false, nameTableKind: None, sysroot: "/Library/Developer/CommandLineTools/SDKs/MacOSX14.sdk", sdk: "MacOSX14.sdk")
+!1 = !DIFile(filename: "test5.c", directory: "/Users/z5489735/2023/0513/Software-Security-Analysis/Assignment-3/Tests/ae")
+!2 = !{i32 7, !"Dwarf Version", i32 4}
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = !{i32 1, !"wchar_size", i32 4}
+!5 = !{i32 8, !"PIC Level", i32 2}
+!6 = !{i32 7, !"uwtable", i32 1}
+!7 = !{i32 7, !"frame-pointer", i32 1}
+!8 = !{!"Homebrew clang version 16.0.6"}
+!9 = distinct !DISubprogram(name: "f", scope: !1, file: !1, line: 6, type: !10, scopeLine: 7, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !13)
+!10 = !DISubroutineType(types: !11)
+!11 = !{!12, !12}
+!12 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!13 = !{}
+!14 = !DILocalVariable(name: "n", arg: 1, scope: !9, file: !1, line: 6, type: !12)
+!15 = !DILocation(line: 0, scope: !9)
+!16 = !DILocation(line: 8, column: 11, scope: !17)
+!17 = distinct !DILexicalBlock(scope: !9, file: !1, line: 8, column: 9)
+!18 = !DILocation(line: 8, column: 9, scope: !9)
+!19 = !DILocation(line: 9, column: 9, scope: !17)
+!20 = !DILocation(line: 10, column: 17, scope: !9)
+!21 = !DILocation(line: 10, column: 13, scope: !9)
+!22 = !DILocation(line: 10, column: 22, scope: !9)
+!23 = !DILocalVariable(name: "r", scope: !9, file: !1, line: 10, type: !12)
+!24 = !DILocation(line: 11, column: 11, scope: !25)
+!25 = distinct !DILexicalBlock(scope: !9, file: !1, line: 11, column: 9)
+!26 = !DILocation(line: 11, column: 9, scope: !9)
+!27 = !DILocation(line: 12, column: 9, scope: !25)
+!28 = !DILocation(line: 13, column: 5, scope: !9)
+!29 = !DILocation(line: 14, column: 1, scope: !9)
+!30 = distinct !DISubprogram(name: "g", scope: !1, file: !1, line: 16, type: !10, scopeLine: 17, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !13)
+!31 = !DILocalVariable(name: "n", arg: 1, scope: !30, file: !1, line: 16, type: !12)
+!32 = !DILocation(line: 0, scope: !30)
+!33 = !DILocation(line: 18, column: 12, scope: !30)
+!34 = !DILocation(line: 18, column: 5, scope: !30)
+!35 = distinct !DISubprogram(name: "main", scope: !1, file: !1, line: 21, type: !36, scopeLine: 21, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !13)
+!36 = !DISubroutineType(types: !37)
+!37 = !{!12}
+!38 = !DILocation(line: 23, column: 7, scope: !35)
+!39 = !DILocalVariable(name: "r", scope: !35, file: !1, line: 22, type: !12)
+!40 = !DILocation(line: 0, scope: !35)
+!41 = !DILocation(line: 24, column: 16, scope: !35)
+!42 = !DILocation(line: 24, column: 3, scope: !35)
+!43 = !DILocation(line: 25, column: 16, scope: !35)
+!44 = !DILocation(line: 25, column: 3, scope: !35)
+!45 = !DILocation(line: 26, column: 3, scope: !35)
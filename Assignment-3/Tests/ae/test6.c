@@ -0,0 +1,18 @@
+#include "stdbool.h"
+extern void svf_assert(bool);
+
+int inc(int x)
+{
+    return x + 1;
+}
+
+// -ae-sparse joins the values of inc over both calls, so a and b are only known to be in [2, 6] there
+int main() {
+  int a = inc(1);
+  int b = inc(5);
+  svf_assert(a >= 2);
+  svf_assert(a <= 6);
+  svf_assert(b >= 2);
+  svf_assert(b <= 6);
+  return 0;
+}
@@ -0,0 +1,82 @@
+; ModuleID = './test6.ll'
+source_filename = "test6.c"
+target datalayout = "e-m:o-i64:64-i128:128-n32:64-S128"
+target triple = "arm64-apple-macosx14.0.0"
+
+; Function Attrs: noinline nounwind ssp uwtable(sync)
+define i32 @inc(i32 noundef %x) #0 !dbg !9 {
+entry:
+  call void @llvm.dbg.value(metadata i32 %x, metadata !14, metadata !DIExpression()), !dbg !15
+  %add = add nsw i32 %x, 1, !dbg !16
+  ret i32 %add, !dbg !17
+}
+
+; Function Attrs: noinline nounwind ssp uwtable(sync)
+define i32 @main() #0 !dbg !18 {
+entry:
+  %call = call i32 @inc(i32 noundef 1), !dbg !22
+  call void @llvm.dbg.value(metadata i32 %call, metadata !21, metadata !DIExpression()), !dbg !23
+  %call1 = call i32 @inc(i32 noundef 5), !dbg !25
+  call void @llvm.dbg.value(metadata i32 %call1, metadata !24, metadata !DIExpression()), !dbg !23
+  %cmp = icmp sge i32 %call, 2, !dbg !26
+  call void @svf_assert(i1 noundef zeroext %cmp), !dbg !27
+  %cmp2 = icmp sle i32 %call, 6, !dbg !28
+  call void @svf_assert(i1 noundef zeroext %cmp2), !dbg !29
+  %cmp3 = icmp sge i32 %call1, 2, !dbg !30
+  call void @svf_assert(i1 noundef zeroext %cmp3), !dbg !31
+  %cmp4 = icmp sle i32 %call1, 6, !dbg !32
+  call void @svf_assert(i1 noundef zeroext %cmp4), !dbg !33
+  ret i32 0, !dbg !34
+}
+
+; Function Attrs: nocallback nofree nosync nounwind speculatable willreturn memory(none)
+declare void @llvm.dbg.declare(metadata, metadata, metadata) #1
+
+declare void @svf_assert(i1 noundef zeroext) #2
+
+; Function Attrs: nocallback nofree nosync nounwind speculatable willreturn memory(none)
+declare void @llvm.dbg.value(metadata, metadata, metadata) #1
+
+attributes #0 = { noinline nounwind ssp uwtable(sync) "frame-pointer"="non-leaf" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="apple-m1" "target-features"="+aes,+crc,+crypto,+dotprod,+fp-armv8,+fp16fml,+fullfp16,+lse,+neon,+ras,+rcpc,+rdm,+sha2,+sha3,+sm4,+v8.1a,+v8.2a,+v8.3a,+v8.4a,+v8.5a,+v8a,+zcm,+zcz" }
+attributes #1 = { nocallback nofree nosync nounwind speculatable willreturn memory(none) }
+attributes #2 = { "frame-pointer"="non-leaf" "no-trapping-math"="true" "stack-protector-buffer-size"="8" "target-cpu"="apple-m1" "target-features"="+aes,+crc,+crypto,+dotprod,+fp-armv8,+fp16fml,+fullfp16,+lse,+neon,+ras,+rcpc,+rdm,+sha2,+sha3,+sm4,+v8.1a,+v8.2a,+v8.3a,+v8.4a,+v8.5a,+v8a,+zcm,+zcz" }
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!2, !3, !4, !5, !6, !7}
+!llvm.ident = !{!8}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C11, file: !1, producer: "Homebrew clang version 16.0.6", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, splitDebugInlining: false, nameTableKind: None, sysroot: "/Library/Developer/CommandLineTools/SDKs/MacOSX14.sdk", sdk: "MacOSX14.sdk")
+!1 = !DIFile(filename: "test6.c", directory: "/Users/z5489735/2023/0513/Software-Security-Analysis/Assignment-3/Tests/ae")
+!2 = !{i32 7, !"Dwarf Version", i32 4}
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = !{i32 1, !"wchar_size", i32 4}
+!5 = !{i32 8, !"PIC Level", i32 2}
+!6 = !{i32 7, !"uwtable", i32 1}
+!7 = !{i32 7, !"frame-pointer", i32 1}
+!8 = !{!"Homebrew clang version 16.0.6"}
+!9 = distinct !DISubprogram(name: "inc", scope: !1, file: !1, line: 4, type: !10, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !13)
+!10 = !DISubroutineType(types: !11)
+!11 = !{!12, !12}
+!12 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!13 = !{}
+!14 = !DILocalVariable(name: "x", arg: 1, scope: !9, file: !1, line: 4, type: !12)
+!15 = !DILocation(line: 0, scope: !9)
+!16 = !DILocation(line: 6, column: 14, scope: !9)
+!17 = !DILocation(line: 6, column: 5, scope: !9)
+!18 = distinct !DISubprogram(name: "main", scope: !1, file: !1, line: 10, type: !19, scopeLine: 10, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !13)
+!19 = !DISubroutineType(types: !20)
+!20 = !{!12}
+!21 = !DILocalVariable(name: "a", scope: !18, file: !1, line: 11, type: !12)
+!22 = !DILocation(line: 11, column: 11, scope: !18)
+!23 = !DILocation(line: 0, scope: !18)
+!24 = !DILocalVariable(name: "b", scope: !18, file: !1, line: 12, type: !12)
+!25 = !DILocation(line: 12, column: 11, scope: !18)
+!26 = !DILocation(line: 13, column: 16, scope: !18)
+!27 = !DILocation(line: 13, column: 3, scope: !18)
+!28 = !DILocation(line: 14, column: 16, scope: !18)
+!29 = !DILocation(line: 14, column: 3, scope: !18)
+!30 = !DILocation(line: 15, column: 16, scope: !18)
+!31 = !DILocation(line: 15, column: 3, scope: !18)
+!32 = !DILocation(line: 16, column: 16, scope: !18)
+!33 = !DILocation(line: 16, column: 3, scope: !18)
+!34 = !DILocation(line: 17, column: 3, scope: !18)
@@ -0,0 +1,36 @@
+#!/bin/bash
+
+# Benchmark ass3 over the test cases of Assignment-3
+# Usage: ./bench.sh ["<ass3 options of config 1>" "<ass3 options of config 2>" ...]
+# e.g.   ./bench.sh "-ae-wto-worklist=false" "-ae-wto-worklist"
+#        ./bench.sh "" "-ae-sparse" "-ae-summaries=4"
+# The ass3 binary is taken from $ASS3 (default: bin/ass3 of the project root)
+
+# Locate the ass3 binary and the test cases relative to this script
+script_dir=$(cd "$(dirname "$0")" && pwd)
+ass3=${ASS3:-$script_dir/../bin/ass3}
+tests=$(ls "$script_dir"/Tests/ae/*.ll "$script_dir"/Tests/buf/*.ll)
+
+# Use the default configuration if none is provided
+if [ $# -eq 0 ]; then
+    set -- ""
+fi
+
+printf "%-12s %-40s %10s %12s %12s %14s\n" "Test" "Options" "Time(ms)" "WTOTime(s)" "Node visits" "PeakMemory(KB)"
+for test in $tests; do
+    for options in "$@"; do
+        # The buffer overflow tests are run with -overflow as in ctest
+        extra=""
+        if [ "$(basename "$(dirname "$test")")" = "buf" ]; then
+            extra="-overflow"
+        fi
+        start=$(date +%s%N)
+        output=$("$ass3" -ae-stat $extra $options "$test" 2>&1)
+        end=$(date +%s%N)
+        wto=$(echo "$output" | awk '/^WTOTime/ {print $NF}')
+        visits=$(echo "$output" | awk '/#Node visits/ {print $NF}')
+        memory=$(echo "$output" | awk '/^PeakMemory/ {print $NF}')
+        printf "%-12s %-40s %10d %12s %12s %14s\n" "$(basename "$(dirname "$test")")/$(basename "$test" .ll)" \
+            "${options:-default}" $(((end - start) / 1000000)) "$wto" "$visits" "$memory"
+    done
+done
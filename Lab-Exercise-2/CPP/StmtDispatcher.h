@@ -0,0 +1,88 @@
+//===- StmtDispatcher.h -- Kind-indexed dispatch of SVF statements ------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2022>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+/*
+ * Kind-indexed dispatch of SVF statements, shared by the symbolic execution (Assignment-2)
+ * and the abstract execution (Assignment-3)
+ *
+ * Created on: Feb 19, 2024
+ */
+
+#ifndef SOFTWARE_SECURITY_ANALYSIS_STMTDISPATCHER_H
+#define SOFTWARE_SECURITY_ANALYSIS_STMTDISPATCHER_H
+
+#include "SVFIR/SVFIR.h"
+#include <array>
+
+namespace SVF {
+
+	/// A table of statement handlers of an engine indexed by SVFStmt::getEdgeKind(), replacing a chain of dyn_casts
+	/// with one indirect call. Each entry is a thunk instantiated for its statement class, so the statement is cast
+	/// statically and the engine's handler is called directly, e.g.,
+	///     dispatcher.set<SVFStmt::Addr, AddrStmt, &AbstractExecution::updateStateOnAddr>();
+	///     dispatcher.dispatch(*this, stmt);
+	/// Args are extra arguments passed to every handler (e.g., the ICFG edge being translated)
+	template <typename Engine, typename Result = void, typename... Args>
+	class StmtDispatcher {
+	 public:
+		typedef Result (*Handler)(Engine&, const SVFStmt*, Args...);
+
+		/// Handle the statements of `kind`, which are instances of STMT, with `handler`
+		template <SVFStmt::PEDGEK kind, typename STMT, Result (Engine::*handler)(const STMT*, Args...)>
+		void set() {
+			table[kind] = &call<STMT, handler>;
+		}
+
+		/// Statements of `kind` need no handling
+		void ignore(SVFStmt::PEDGEK kind) {
+			table[kind] = &skip;
+		}
+
+		/// The handler of `kind`, e.g., to resolve it once for a statement visited many times
+		inline Handler getHandler(SVFStmt::PEDGEK kind) const {
+			assert(table[kind] && "implement this part");
+			return table[kind];
+		}
+
+		/// Call the handler of the statement's kind
+		inline Result dispatch(Engine& engine, const SVFStmt* stmt, Args... args) const {
+			Handler handler = table[stmt->getEdgeKind()];
+			assert(handler && "implement this part");
+			return handler(engine, stmt, args...);
+		}
+
+	 private:
+		template <typename STMT, Result (Engine::*handler)(const STMT*, Args...)>
+		static Result call(Engine& engine, const SVFStmt* stmt, Args... args) {
+			assert(SVFUtil::isa<STMT>(stmt) && "statement kind and class mismatch?");
+			return (engine.*handler)(static_cast<const STMT*>(stmt), args...);
+		}
+
+		static Result skip(Engine&, const SVFStmt*, Args...) {
+			return Result();
+		}
+
+		std::array<Handler, SVFStmt::ThreadJoin + 1> table{};
+	};
+
+} // namespace SVF
+
+#endif // SOFTWARE_SECURITY_ANALYSIS_STMTDISPATCHER_H
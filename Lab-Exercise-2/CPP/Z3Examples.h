@@ -97,12 +97,12 @@ namespace SVF {
 
 		// Add an z3 expression into solver for later satisfiability solving
 		void addToSolver(z3::expr e) {
-			solver.add(e);
+			getSolver().add(e);
 		}
 
 		// Reset solver's stack and clear up the maps
 		void resetSolver() {
-			solver.reset();
+			getSolver().reset();
 			strToIDMap.clear();
 			currentExprIdx = 0;
 			clearVarID2ExprMap();
@@ -26,6 +26,7 @@
  */
 
 #include "Z3Mgr.h"
+#include <climits>
 #include <iomanip>
 #include <iostream>
 #include <set>
@@ -57,21 +58,78 @@ z3::expr Z3Mgr::loadValue(const z3::expr loc) {
 s32_t Z3Mgr::z3Expr2NumValue(z3::expr e) {
 	z3::expr val = getEvalExpr(e);
 	if (val.is_numeral())
-		return val.get_numeral_int64();
+		return getNumeralValue(val);
 	else {
 		assert(false && "this expression is not numeral");
 		abort();
 	}
 }
 
+int64_t Z3Mgr::getNumeralValue(const z3::expr& e) const {
+	if (e.is_bv()) {
+		uint64_t val = e.get_numeral_uint64();
+		u32_t width = e.get_sort().bv_size();
+		if (width < 64 && ((val >> (width - 1)) & 1))
+			return (int64_t)val - ((int64_t)1 << width);
+		return (int64_t)val;
+	}
+	return e.get_numeral_int64();
+}
+
+void Z3Mgr::setTactics(const std::string& tactics) {
+	if (tactics.empty())
+		return;
+	this->tactics = tactics;
+	getSolver() = mkSolver();
+}
+
+z3::solver Z3Mgr::mkSolver() {
+	if (tactics.empty())
+		return z3::solver(ctx);
+	std::stringstream names(tactics);
+	std::string name;
+	std::getline(names, name, ',');
+	z3::tactic t(ctx, name.c_str());
+	while (std::getline(names, name, ','))
+		t = t & z3::tactic(ctx, name.c_str());
+	return t.mk_solver();
+}
+
+void Z3Mgr::setQueryLimits(z3::solver& s, u32_t timeout, u32_t rlimit) {
+	z3::params p(ctx);
+	p.set("timeout", timeout == 0 ? UINT_MAX : timeout);
+	p.set("rlimit", rlimit);
+	s.set(p);
+}
+
 /// It checks if the constraints added to the Z3 solver are satisfiable.
 /// If they are, it retrieves the model that satisfies these constraints
 /// and evaluates the given complex expression e within this model, returning the evaluated result
 z3::expr Z3Mgr::getEvalExpr(z3::expr e) {
-	z3::check_result res = solver.check();
+	z3::check_result res = checkOnce();
 	assert(res != z3::unsat && "unsatisfied constraints! Check your contradictory constraints added to the solver");
-	z3::model m = solver.get_model();
-	return m.eval(e);
+	// an undecided solver has no model to evaluate e in
+	if (res != z3::sat)
+		return e;
+	return getModel().eval(e);
+}
+
+z3::check_result Z3Mgr::checkOnce() {
+	u32_t scopes = Z3_solver_get_num_scopes(ctx, solver);
+	if (checked && scopes == checkedScopes && addedAssertions == checkedAdded)
+		return lastResult;
+	lastResult = solver.check();
+	if (lastResult == z3::sat)
+		lastModel = solver.get_model();
+	checked = true;
+	checkedScopes = scopes;
+	checkedAdded = addedAssertions;
+	return lastResult;
+}
+
+const z3::model& Z3Mgr::getModel() {
+	assert(checked && lastResult == z3::sat && "no model, call checkOnce first!");
+	return lastModel;
 }
 
 /// Print all expressions' values after evaluation
@@ -81,7 +139,7 @@ void Z3Mgr::printExprValues() {
 	for (u32_t i = 0; i < lastSlot; i++) {
 		expr e = getEvalExpr(varID2ExprMap[i]);
 		if (e.is_numeral()) {
-			s32_t value = e.get_numeral_int64();
+			s32_t value = getNumeralValue(e);
 			std::stringstream exprName;
 			exprName << "Var" << i;
 			std::cout << std::setw(25) << exprName.str();
@@ -50,11 +50,14 @@ namespace SVF {
 	/// Z3 manager interface
 	class Z3Mgr {
 	 public:
-		/// Constructor
-		Z3Mgr(u32_t numOfMapElems)
+		/// Constructor. Values are encoded as unbounded integers if bvWidth is 0, and as bit-vectors of bvWidth
+		/// bits (e.g., 32 or 64) otherwise
+		Z3Mgr(u32_t numOfMapElems, u32_t bvWidth = 0)
 		: solver(ctx)
+		, lastModel(ctx)
 		, varID2ExprMap(ctx)
-		, lastSlot(numOfMapElems) {
+		, lastSlot(numOfMapElems)
+		, bvWidth(bvWidth) {
 			resetZ3ExprMap();
 		}
 
@@ -63,10 +66,52 @@ namespace SVF {
 		/// loc2ValMap: maps an address location to its stored value, e.g., loc2ValMap[addr] = val
 		inline void resetZ3ExprMap() {
 			varID2ExprMap.resize(lastSlot + 1);
-			z3::expr loc2ValMap = ctx.constant("loc2ValMap", ctx.array_sort(ctx.int_sort(), ctx.int_sort()));
+			exprSet.assign(lastSlot + 1, false);
+			z3::expr loc2ValMap = ctx.constant("loc2ValMap", ctx.array_sort(getValSort(), getValSort()));
 			updateZ3Expr(lastSlot, loc2ValMap);
 		}
 
+		/// Encoding of values: Int or bit-vectors of bvWidth bits. Use these instead of ctx.int_val/int_const
+		/// so that the same code works under both encodings
+		///@{
+		inline bool isBVEncoding() const {
+			return bvWidth != 0;
+		}
+		inline z3::sort getValSort() {
+			return isBVEncoding() ? ctx.bv_sort(bvWidth) : ctx.int_sort();
+		}
+		inline z3::expr getNumeral(int64_t val) {
+			return isBVEncoding() ? ctx.bv_val(val, bvWidth) : ctx.int_val(val);
+		}
+		inline z3::expr getConst(const char* name) {
+			return ctx.constant(name, getValSort());
+		}
+		///@}
+
+		/// Build the solver from a comma-separated list of tactics applied in sequence,
+		/// e.g., "simplify,solve-eqs,bit-blast,sat". An empty list keeps Z3's default solver
+		void setTactics(const std::string& tactics);
+
+		/// Return a new solver built like the current one (from the tactics of setTactics, if any), e.g., to check a
+		/// subset of the constraints on its own
+		z3::solver mkSolver();
+
+		/// Bound the following solver checks by a timeout in milliseconds and a resource limit (0 means no bound)
+		void setQueryLimits(u32_t timeout, u32_t rlimit) {
+			setQueryLimits(solver, timeout, rlimit);
+		}
+		void setQueryLimits(z3::solver& s, u32_t timeout, u32_t rlimit);
+
+		/// Return/replace the current memory model (loc2ValMap), e.g., to restore it when backtracking
+		///@{
+		inline z3::expr getMemModel() const {
+			return varID2ExprMap[lastSlot];
+		}
+		inline void setMemModel(z3::expr loc2ValMap) {
+			varID2ExprMap.set(lastSlot, loc2ValMap);
+		}
+		///@}
+
 		/// Store and Select for Loc2ValMap, i.e., store and load
 		z3::expr storeValue(const z3::expr loc, const z3::expr value);
 		z3::expr loadValue(const z3::expr loc);
@@ -107,11 +152,28 @@ namespace SVF {
 		inline void updateZ3Expr(u32_t idx, z3::expr target) {
 			assert(varID2ExprMap.size() >= idx + 1 && "idx out of bound for map access, increase map size!");
 			varID2ExprMap.set(getInternalID(idx), target);
+			exprSet[getInternalID(idx)] = true;
+		}
+
+		/// Return true if an expression has been set for idx via updateZ3Expr
+		inline bool isZ3ExprSet(u32_t idx) const {
+			return idx < exprSet.size() && exprSet[idx];
 		}
 
 		/// Return int value from an expression if it is a numeral, otherwise return an approximate value
 		s32_t z3Expr2NumValue(z3::expr e);
 
+		/// Return the signed value of a numeral (bit-vector numerals are read in two's complement)
+		int64_t getNumeralValue(const z3::expr& e) const;
+
+		/// Check the solver once and keep the result (and the model if sat) until the solver is accessed again via
+		/// getSolver, an assertion is added via addToSolver or its scopes change, so that consecutive evaluations
+		/// share one check and one model
+		z3::check_result checkOnce();
+
+		/// Return the model of the last checkOnce, which must be sat
+		const z3::model& getModel();
+
 		/// It checks if the constraints added to the Z3 solver are satisfiable.
 		/// If they are, it retrieves the model that satisfies these constraints
 		/// and evaluates the given complex expression e within this model, returning the evaluated result
@@ -123,8 +185,15 @@ namespace SVF {
 		// Print all Z3 expressions
 		void printZ3Exprs();
 
-		/// Return the z3 solver
+		/// Add an assertion to the solver, counted so that checkOnce sees the change without reading the assertions
+		inline void addToSolver(const z3::expr& e) {
+			solver.add(e);
+			addedAssertions++;
+		}
+
+		/// Return the z3 solver. The caller may change it, so the result of checkOnce is dropped
 		inline z3::solver& getSolver() {
+			checked = false;
 			return solver;
 		}
 		/// Return the z3 solver context (typically corresponding to a program)
@@ -146,19 +215,32 @@ namespace SVF {
 			// negative check
 			getSolver().push();
 			getSolver().add(!q);
-			getSolver().check();
-			bool res = getSolver().check() == z3::unsat;
+			bool res = checkOnce() == z3::unsat;
 			getSolver().pop();
 			return res;
 		}
 
 	 protected:
 		z3::context ctx;
-		z3::solver solver;
+		z3::solver solver;	/// access it through getSolver so that the result of checkOnce is dropped on changes
+
+		/// Result and model of the last checkOnce, valid while `checked` holds, the solver has the scopes it had and
+		/// addToSolver added nothing since
+		///@{
+		bool checked = false;
+		u32_t checkedScopes = 0;
+		u32_t checkedAdded = 0;
+		u32_t addedAssertions = 0;	/// assertions added via addToSolver
+		z3::check_result lastResult = z3::unknown;
+		z3::model lastModel;
+		///@}
 
 	 private:
 		z3::expr_vector varID2ExprMap;	/// var to z3 expression
 		u32_t lastSlot;		/// the last slot in the map for the z3 expression.
+		u32_t bvWidth;		/// bit width of values, 0 for the Int encoding
+		std::string tactics;	/// the tactics of setTactics, empty for Z3's default solver
+		std::vector<bool> exprSet;	/// whether a slot of varID2ExprMap holds an expression
 	};
 
 } // namespace SVF